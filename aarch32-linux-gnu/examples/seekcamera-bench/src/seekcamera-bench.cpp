@@ -0,0 +1,899 @@
+/*Copyright (c) [2020] [Seek Thermal, Inc.]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The Software may only be used in combination with Seek cores/products.
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:	 Seek Thermal SDK Demo
+ * Purpose:	 Measures the host resources used to stream from Seek Thermal Cameras
+ * Author:	 Seek Thermal, Inc.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+// C includes
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Linux includes
+#include <dirent.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Seek SDK includes
+#include "seekcamera/seekcamera.h"
+#include "seekcamera/seekcamera_frame.h"
+#include "seekcamera/seekcamera_manager.h"
+#include "seekframe/seekframe.h"
+
+// Structure representing a thread of the process.
+struct seekbench_thread_t
+{
+	pid_t tid{};
+	std::string name;
+};
+
+// Structure representing the frame statistics of a camera.
+struct seekbench_frames_t
+{
+	std::string hub;
+	uint64_t num_frames{};
+	uint64_t num_bytes{};
+	int64_t max_interval_ns{};
+};
+
+// Structure representing a snapshot of the resources used by the process.
+struct seekbench_usage_t
+{
+	std::chrono::steady_clock::time_point time;
+	double cpu_sec{};
+	long num_voluntary_switches{};
+	long num_involuntary_switches{};
+	std::vector<seekbench_thread_t> threads;
+	std::map<std::string, seekbench_frames_t> frames;
+};
+
+// Structure representing the scheduling applied to the SDK threads.
+struct seekbench_sched_t
+{
+	bool has_affinity{};
+	cpu_set_t affinity;
+	int priority{};
+};
+
+// Structure representing a streaming benchmark.
+// Frames are counted per camera and otherwise dropped so that the measured cost is that of the SDK alone.
+struct seekbench_t
+{
+	// Structure representing a camera under test.
+	struct camera_t
+	{
+		seekcamera_chipid_t cid;
+		std::string hub;
+		uint32_t frame_format{};
+		bool is_streaming{};
+		std::atomic<uint64_t> num_frames;
+		std::atomic<uint64_t> num_bytes;
+		std::atomic<int64_t> max_interval_ns;
+		std::chrono::steady_clock::time_point last_frame_time;
+		bool has_last_frame_time{};
+	};
+
+	uint32_t frame_format{};
+	int gradient_correction{ -1 };
+	int agc_mode{ -1 };
+	int max_cameras_per_hub{};
+	std::mutex cameras_mutex;
+	std::map<seekcamera_t*, std::unique_ptr<camera_t>> cameras;
+};
+
+// Define the global variables.
+static std::atomic<bool> g_exit_requested;
+
+// Lists the threads of the process along with their names.
+std::vector<seekbench_thread_t> seekbench_get_threads()
+{
+	std::vector<seekbench_thread_t> threads;
+	DIR* dir = opendir("/proc/self/task");
+	if(dir != nullptr)
+	{
+		for(struct dirent* entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+		{
+			if(entry->d_name[0] == '.')
+			{
+				continue;
+			}
+
+			seekbench_thread_t thread;
+			thread.tid = (pid_t)std::atoi(entry->d_name);
+
+			std::ifstream comm(std::string("/proc/self/task/") + entry->d_name + "/comm");
+			std::getline(comm, thread.name);
+			threads.push_back(thread);
+		}
+		closedir(dir);
+	}
+
+	std::sort(threads.begin(), threads.end(), [](const seekbench_thread_t& lhs, const seekbench_thread_t& rhs) {
+		return lhs.tid < rhs.tid;
+	});
+
+	return threads;
+}
+
+// Parses a comma separated list of frame formats such as "thermography,color" into a frame format mask.
+// Returns zero if any format is unknown.
+uint32_t seekbench_parse_frame_formats(const std::string& list)
+{
+	static const std::map<std::string, seekcamera_frame_format_t> formats = {
+		{ "corrected", SEEKCAMERA_FRAME_FORMAT_CORRECTED },
+		{ "pre-agc", SEEKCAMERA_FRAME_FORMAT_PRE_AGC },
+		{ "thermography", SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT },
+		{ "grayscale", SEEKCAMERA_FRAME_FORMAT_GRAYSCALE },
+		{ "color", SEEKCAMERA_FRAME_FORMAT_COLOR_ARGB8888 },
+	};
+
+	uint32_t frame_format = 0;
+	std::stringstream stream(list);
+	std::string name;
+	while(std::getline(stream, name, ','))
+	{
+		const auto iter = formats.find(name);
+		if(iter == formats.end())
+		{
+			return 0;
+		}
+		frame_format |= static_cast<uint32_t>(iter->second);
+	}
+
+	return frame_format;
+}
+
+// Gets the hub a camera is attached to from its IO properties.
+// USB cameras are keyed by the sysfs name of their parent hub, e.g. 1-1 for a camera at 1-1.2 or usb1 for a camera
+// plugged into a root port of bus 1. Cameras behind the same hub share its upstream bandwidth.
+// SPI cameras are keyed by their bus, e.g. spi0, since every chip select shares the bus clock.
+std::string seekbench_get_hub(const seekcamera_io_properties_t& io)
+{
+	std::string hub;
+	if(io.type == SEEKCAMERA_IO_TYPE_USB)
+	{
+		// Zero (0) is reserved for invalid ports; any non-zero ports are valid.
+		size_t num_ports = 0;
+		while(num_ports < sizeof(io.properties.usb.port_numbers) && io.properties.usb.port_numbers[num_ports] != 0)
+		{
+			++num_ports;
+		}
+
+		if(num_ports <= 1)
+		{
+			return "usb" + std::to_string(io.properties.usb.bus_number);
+		}
+
+		hub = std::to_string(io.properties.usb.bus_number) + '-' + std::to_string(io.properties.usb.port_numbers[0]);
+		for(size_t i = 1; i + 1 < num_ports; ++i)
+		{
+			hub += '.' + std::to_string(io.properties.usb.port_numbers[i]);
+		}
+	}
+	else if(io.type == SEEKCAMERA_IO_TYPE_SPI)
+	{
+		hub = "spi" + std::to_string(io.properties.spi.bus_number);
+	}
+
+	return hub;
+}
+
+// Gets the number of bytes delivered so far to each hub.
+std::map<std::string, uint64_t> seekbench_get_hub_bytes(seekbench_t* bench)
+{
+	std::map<std::string, uint64_t> hub_bytes;
+
+	// Enter critical section.
+	std::lock_guard<std::mutex> lock(bench->cameras_mutex);
+	for(auto& kvp : bench->cameras)
+	{
+		hub_bytes[kvp.second->hub] += kvp.second->num_bytes.load();
+	}
+
+	return hub_bytes;
+}
+
+// Parses a CPU list such as "2-3,6" into a CPU set.
+// Returns true on success.
+bool seekbench_parse_cpu_list(const std::string& list, cpu_set_t* set)
+{
+	CPU_ZERO(set);
+
+	std::stringstream stream(list);
+	std::string range;
+	while(std::getline(stream, range, ','))
+	{
+		int first = -1;
+		int last = -1;
+		const int num_fields = std::sscanf(range.c_str(), "%d-%d", &first, &last);
+		if(num_fields == 1)
+		{
+			last = first;
+		}
+
+		if(num_fields < 1 || first < 0 || last < first || last >= CPU_SETSIZE)
+		{
+			return false;
+		}
+
+		for(int cpu = first; cpu <= last; ++cpu)
+		{
+			CPU_SET(cpu, set);
+		}
+	}
+
+	return CPU_COUNT(set) > 0;
+}
+
+// Applies the CPU affinity and real-time priority to every thread of the process except the main thread.
+// Only threads that exist when this is called are affected; it is called once the cameras are streaming.
+void seekbench_apply_sched(const seekbench_sched_t& sched)
+{
+	const pid_t main_tid = getpid();
+	for(const seekbench_thread_t& thread : seekbench_get_threads())
+	{
+		if(thread.tid == main_tid)
+		{
+			continue;
+		}
+
+		if(sched.has_affinity && sched_setaffinity(thread.tid, sizeof(cpu_set_t), &sched.affinity) != 0)
+		{
+			std::cerr << "failed to set CPU affinity: " << thread.name << " (TID: " << thread.tid << ") " << strerror(errno) << std::endl;
+		}
+
+		if(sched.priority > 0)
+		{
+			struct sched_param param;
+			memset(&param, 0, sizeof(param));
+			param.sched_priority = sched.priority;
+			if(sched_setscheduler(thread.tid, SCHED_FIFO, &param) != 0)
+			{
+				std::cerr << "failed to set SCHED_FIFO priority: " << thread.name << " (TID: " << thread.tid << ") " << strerror(errno) << std::endl;
+			}
+		}
+	}
+}
+
+// Takes a snapshot of the resources used by the process and of the frame count of each camera.
+seekbench_usage_t seekbench_get_usage(seekbench_t* bench)
+{
+	seekbench_usage_t usage;
+	usage.time = std::chrono::steady_clock::now();
+
+	struct rusage rusage;
+	memset(&rusage, 0, sizeof(rusage));
+	getrusage(RUSAGE_SELF, &rusage);
+	usage.cpu_sec =
+		(double)(rusage.ru_utime.tv_sec + rusage.ru_stime.tv_sec) +
+		(double)(rusage.ru_utime.tv_usec + rusage.ru_stime.tv_usec) / 1000000.0;
+	usage.num_voluntary_switches = rusage.ru_nvcsw;
+	usage.num_involuntary_switches = rusage.ru_nivcsw;
+	usage.threads = seekbench_get_threads();
+
+	// Enter critical section.
+	// The largest frame interval is reset so that each snapshot reports the largest interval since the previous one.
+	std::lock_guard<std::mutex> lock(bench->cameras_mutex);
+	for(auto& kvp : bench->cameras)
+	{
+		seekbench_frames_t& frames = usage.frames[kvp.second->cid];
+		frames.hub = kvp.second->hub;
+		frames.num_frames = kvp.second->num_frames.load();
+		frames.num_bytes = kvp.second->num_bytes.load();
+		frames.max_interval_ns = kvp.second->max_interval_ns.exchange(0);
+	}
+
+	return usage;
+}
+
+// Prints the resources used between two snapshots.
+void seekbench_print_report(const seekbench_usage_t& start, const seekbench_usage_t& end)
+{
+	const double elapsed_sec = std::chrono::duration_cast<std::chrono::milliseconds>(end.time - start.time).count() / 1000.0;
+	const double cpu_percent = elapsed_sec > 0.0 ? 100.0 * (end.cpu_sec - start.cpu_sec) / elapsed_sec : 0.0;
+	const size_t num_cameras = end.frames.size();
+	uint64_t total_frames = 0;
+
+	std::fprintf(stdout, "+---------------------------------------------------------+\n");
+	std::fprintf(stdout, "| %-12s | %-12s | %-10s | %-12s |\n", "CID", "FRAMES", "FPS", "MAX GAP (ms)");
+	std::fprintf(stdout, "+---------------------------------------------------------+\n");
+	for(const auto& kvp : end.frames)
+	{
+		const auto iter = start.frames.find(kvp.first);
+		const uint64_t num_frames = kvp.second.num_frames - (iter != start.frames.end() ? iter->second.num_frames : 0);
+		total_frames += num_frames;
+		std::fprintf(stdout, "| %-12s | %-12llu | %-10.2f | %-12.2f |\n",
+			kvp.first.c_str(),
+			(unsigned long long)num_frames,
+			elapsed_sec > 0.0 ? (double)num_frames / elapsed_sec : 0.0,
+			(double)kvp.second.max_interval_ns / 1000000.0);
+	}
+	std::fprintf(stdout, "+---------------------------------------------------------+\n");
+
+	// Aggregate the cameras by the hub they share.
+	struct hub_t
+	{
+		size_t num_cameras{};
+		uint64_t num_frames{};
+		uint64_t num_bytes{};
+	};
+	std::map<std::string, hub_t> hubs;
+	for(const auto& kvp : end.frames)
+	{
+		const auto iter = start.frames.find(kvp.first);
+		hub_t& hub = hubs[kvp.second.hub];
+		++hub.num_cameras;
+		hub.num_frames += kvp.second.num_frames - (iter != start.frames.end() ? iter->second.num_frames : 0);
+		hub.num_bytes += kvp.second.num_bytes - (iter != start.frames.end() ? iter->second.num_bytes : 0);
+	}
+
+	std::fprintf(stdout, "| %-12s | %-12s | %-10s | %-12s |\n", "HUB", "CAMERAS", "FPS", "MB/s");
+	std::fprintf(stdout, "+---------------------------------------------------------+\n");
+	for(const auto& kvp : hubs)
+	{
+		std::fprintf(stdout, "| %-12s | %-12zu | %-10.2f | %-12.2f |\n",
+			kvp.first.c_str(),
+			kvp.second.num_cameras,
+			elapsed_sec > 0.0 ? (double)kvp.second.num_frames / elapsed_sec : 0.0,
+			elapsed_sec > 0.0 ? (double)kvp.second.num_bytes / elapsed_sec / 1000000.0 : 0.0);
+	}
+	std::fprintf(stdout, "+---------------------------------------------------------+\n");
+
+	std::cout
+		<< "resources (over " << elapsed_sec << " s):\n"
+		<< "\tcameras:              " << num_cameras << '\n'
+		<< "\tthreads:              " << end.threads.size() << " (" << start.threads.size() << " at start)\n"
+		<< "\tcpu:                  " << cpu_percent << "% of one core\n"
+		<< "\tcpu per camera:       " << (num_cameras > 0 ? cpu_percent / (double)num_cameras : 0.0) << "% of one core\n"
+		<< "\tcpu per frame:        " << (total_frames > 0 ? 1000.0 * (end.cpu_sec - start.cpu_sec) / (double)total_frames : 0.0) << " ms\n"
+		<< "\tvoluntary switches:   " << (elapsed_sec > 0.0 ? (double)(end.num_voluntary_switches - start.num_voluntary_switches) / elapsed_sec : 0.0) << " per s\n"
+		<< "\tinvoluntary switches: " << (elapsed_sec > 0.0 ? (double)(end.num_involuntary_switches - start.num_involuntary_switches) / elapsed_sec : 0.0) << " per s" << std::endl;
+
+	std::cout << "threads:" << std::endl;
+	for(const seekbench_thread_t& thread : end.threads)
+	{
+		std::cout << '\t' << thread.tid << ": " << thread.name << std::endl;
+	}
+}
+
+// Signal handler function.
+static void signal_callback(int signum)
+{
+	(void)signum;
+	std::cout << "\nCaught Ctrl+C\n" << std::endl;
+	g_exit_requested.store(true);
+}
+
+// Prints the usage instructions.
+void print_usage()
+{
+	std::cout
+		<< "Allowed options:\n"
+		<< "\t-m : Discovery mode. Valid options: usb, spi, all (default: usb)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-f : Comma separated frame formats. Valid options: corrected, pre-agc, thermography, grayscale, color (default: thermography)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-w : Warm up duration in seconds before measuring. Valid options: >= 0 (default: 5)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-d : Measurement duration in seconds. Valid options: > 0 (default: 10)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-a : CPU affinity of the SDK threads, e.g. 2-3,6 (default: none)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-p : SCHED_FIFO priority of the SDK threads. Valid options: 1-99 (default: none)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-g : Gradient correction filter. Valid options: on, off (default: camera setting)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-e : AGC mode. Valid options: linear, histeq (default: camera setting)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-n : Maximum number of cameras streaming behind one hub; further cameras are refused. Valid options: >= 0 (default: 0, unlimited)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-i : Interval in seconds between live throughput reports per hub. Valid options: >= 0 (default: 0, off)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-h : Displays this message\n"
+		<< "\t   : Required - No" << std::endl;
+}
+
+// Handles frame available events.
+void handle_camera_frame_available(seekcamera_t* camera, seekcamera_frame_t* camera_frame, void* user_data)
+{
+	(void)camera;
+
+	auto* bench_camera = (seekbench_t::camera_t*)user_data;
+	const auto now = std::chrono::steady_clock::now();
+
+	// Each requested format is delivered as a separate frame.
+	for(uint32_t format = 1; format != 0 && format <= bench_camera->frame_format; format <<= 1)
+	{
+		seekframe_t* frame = nullptr;
+		if((bench_camera->frame_format & format) != 0 &&
+			seekcamera_frame_get_frame_by_format(camera_frame, (seekcamera_frame_format_t)format, &frame) == SEEKCAMERA_SUCCESS)
+		{
+			bench_camera->num_bytes.fetch_add(seekframe_get_data_size(frame), std::memory_order_relaxed);
+		}
+	}
+
+	bench_camera->num_frames.fetch_add(1, std::memory_order_relaxed);
+	if(bench_camera->has_last_frame_time)
+	{
+		// The report resets the maximum with exchange(0); compare_exchange never overwrites a reset with a stale maximum.
+		const int64_t interval_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - bench_camera->last_frame_time).count();
+		int64_t max_interval_ns = bench_camera->max_interval_ns.load(std::memory_order_relaxed);
+		while(interval_ns > max_interval_ns &&
+			!bench_camera->max_interval_ns.compare_exchange_weak(max_interval_ns, interval_ns, std::memory_order_relaxed))
+		{
+		}
+	}
+	bench_camera->last_frame_time = now;
+	bench_camera->has_last_frame_time = true;
+}
+
+// Gets the chip ID of a camera.
+// Cameras that are already tracked are served from their cached chip ID; only newly connected cameras are queried.
+void seekbench_get_cached_chipid(seekbench_t* bench, seekcamera_t* camera, seekcamera_chipid_t* cid)
+{
+	{
+		std::lock_guard<std::mutex> lock(bench->cameras_mutex);
+		const auto iter = bench->cameras.find(camera);
+		if(iter != bench->cameras.end())
+		{
+			std::memcpy(*cid, iter->second->cid, sizeof(seekcamera_chipid_t));
+			return;
+		}
+	}
+
+	seekcamera_get_chipid(camera, cid);
+}
+
+// Handles camera connect events.
+void handle_camera_connect(seekcamera_t* camera, seekcamera_error_t event_status, void* user_data)
+{
+	(void)event_status;
+	auto* bench = (seekbench_t*)user_data;
+
+	std::unique_ptr<seekbench_t::camera_t> bench_camera(new seekbench_t::camera_t());
+	seekcamera_get_chipid(camera, &(bench_camera->cid));
+	bench_camera->frame_format = bench->frame_format;
+	bench_camera->num_frames.store(0);
+	bench_camera->num_bytes.store(0);
+	bench_camera->max_interval_ns.store(0);
+
+	seekcamera_io_properties_t io{};
+	seekcamera_get_io_properties(camera, &io);
+	bench_camera->hub = seekbench_get_hub(io);
+
+	// Refuse cameras that would oversubscribe their hub.
+	// The camera takes its place on the hub in the same critical section so that concurrent connects are counted.
+	seekbench_t::camera_t* entry = bench_camera.get();
+	bool is_reconnect = false;
+	{
+		// Enter critical section.
+		std::lock_guard<std::mutex> lock(bench->cameras_mutex);
+		int num_streaming = 0;
+		for(const auto& kvp : bench->cameras)
+		{
+			if(kvp.first != camera && kvp.second->is_streaming && kvp.second->hub == entry->hub)
+			{
+				++num_streaming;
+			}
+		}
+
+		if(bench->max_cameras_per_hub > 0 && num_streaming >= bench->max_cameras_per_hub)
+		{
+			std::cerr << "refused camera (CID: " << entry->cid << "): hub " << entry->hub
+					  << " already streams " << num_streaming << " cameras (-n " << bench->max_cameras_per_hub << ")" << std::endl;
+			return;
+		}
+
+		// A camera that reconnects keeps its entry so that its counters carry across the reconnect.
+		// The report subtracts the counters at the start of the measurement from those at the end.
+		const auto iter = std::find_if(bench->cameras.begin(), bench->cameras.end(), [&](const decltype(bench->cameras)::value_type& kvp) {
+			return strcmp(kvp.second->cid, entry->cid) == 0;
+		});
+		if(iter != bench->cameras.end())
+		{
+			std::unique_ptr<seekbench_t::camera_t> existing = std::move(iter->second);
+			bench->cameras.erase(iter);
+			existing->hub = entry->hub;
+			existing->frame_format = entry->frame_format;
+			existing->has_last_frame_time = false;
+			bench_camera = std::move(existing);
+			entry = bench_camera.get();
+			is_reconnect = true;
+		}
+
+		entry->is_streaming = true;
+		bench->cameras[camera] = std::move(bench_camera);
+	}
+
+	// Apply the processing settings under test before any frame is processed.
+	seekcamera_error_t status = SEEKCAMERA_SUCCESS;
+	if(bench->gradient_correction >= 0)
+	{
+		status = seekcamera_set_filter_state(camera, SEEKCAMERA_FILTER_GRADIENT_CORRECTION, (seekcamera_filter_state_t)bench->gradient_correction);
+		if(status != SEEKCAMERA_SUCCESS)
+		{
+			std::cerr << "failed to set gradient correction: " << seekcamera_error_get_str(status) << std::endl;
+		}
+	}
+
+	if(bench->agc_mode >= 0)
+	{
+		status = seekcamera_set_agc_mode(camera, (seekcamera_agc_mode_t)bench->agc_mode);
+		if(status != SEEKCAMERA_SUCCESS)
+		{
+			std::cerr << "failed to set AGC mode: " << seekcamera_error_get_str(status) << std::endl;
+		}
+	}
+
+	status = seekcamera_register_frame_available_callback(camera, handle_camera_frame_available, (void*)entry);
+	if(status == SEEKCAMERA_SUCCESS)
+	{
+		status = seekcamera_capture_session_start(camera, bench->frame_format);
+	}
+
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		std::cerr << "failed to start capture session: " << seekcamera_error_get_str(status) << std::endl;
+
+		// Enter critical section.
+		// A reconnected camera keeps the frames it delivered before.
+		std::lock_guard<std::mutex> lock(bench->cameras_mutex);
+		if(is_reconnect)
+		{
+			entry->is_streaming = false;
+		}
+		else
+		{
+			bench->cameras.erase(camera);
+		}
+	}
+}
+
+// Handles camera disconnect events.
+// The camera is kept in the benchmark so that its frames still count towards the report.
+void handle_camera_disconnect(seekcamera_t* camera, seekcamera_error_t event_status, void* user_data)
+{
+	(void)event_status;
+	auto* bench = (seekbench_t*)user_data;
+
+	if(seekcamera_is_active(camera))
+	{
+		seekcamera_capture_session_stop(camera);
+	}
+
+	// Enter critical section.
+	// The camera no longer counts towards the limit of its hub.
+	std::lock_guard<std::mutex> lock(bench->cameras_mutex);
+	const auto iter = bench->cameras.find(camera);
+	if(iter != bench->cameras.end())
+	{
+		iter->second->is_streaming = false;
+	}
+}
+
+// Callback function for the camera manager; it fires whenever a camera event occurs.
+void camera_event_callback(seekcamera_t* camera, seekcamera_manager_event_t event, seekcamera_error_t event_status, void* user_data)
+{
+	seekcamera_chipid_t cid{};
+	seekbench_get_cached_chipid((seekbench_t*)user_data, camera, &cid);
+	std::cout << seekcamera_manager_get_event_str(event) << " (CID: " << cid << ")" << std::endl;
+
+	// Handle the event type.
+	switch(event)
+	{
+		case SEEKCAMERA_MANAGER_EVENT_CONNECT:
+			handle_camera_connect(camera, event_status, user_data);
+			break;
+		case SEEKCAMERA_MANAGER_EVENT_DISCONNECT:
+			handle_camera_disconnect(camera, event_status, user_data);
+			break;
+		case SEEKCAMERA_MANAGER_EVENT_ERROR:
+			std::cerr << "unhandled camera error: (CID: " << cid << ")" << seekcamera_error_get_str(event_status) << std::endl;
+			break;
+		default:
+			break;
+	}
+}
+
+// Sleeps for a number of seconds or until told to stop.
+void seekbench_sleep(int duration_sec)
+{
+	const auto end_time = std::chrono::steady_clock::now() + std::chrono::seconds(duration_sec);
+	while(!g_exit_requested.load() && std::chrono::steady_clock::now() < end_time)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+}
+
+// Measures for a number of seconds, printing the throughput of each hub at every interval.
+void seekbench_measure(seekbench_t* bench, int duration_sec, int interval_sec)
+{
+	if(interval_sec <= 0)
+	{
+		seekbench_sleep(duration_sec);
+		return;
+	}
+
+	auto last_time = std::chrono::steady_clock::now();
+	auto last_bytes = seekbench_get_hub_bytes(bench);
+	for(int elapsed_sec = 0; elapsed_sec < duration_sec && !g_exit_requested.load(); elapsed_sec += interval_sec)
+	{
+		seekbench_sleep(std::min(interval_sec, duration_sec - elapsed_sec));
+
+		const auto now = std::chrono::steady_clock::now();
+		const auto bytes = seekbench_get_hub_bytes(bench);
+		const double interval = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_time).count() / 1000.0;
+		for(const auto& kvp : bytes)
+		{
+			const auto iter = last_bytes.find(kvp.first);
+			const uint64_t num_bytes = kvp.second - (iter != last_bytes.end() ? iter->second : 0);
+			std::fprintf(stdout, "hub %s: %.2f MB/s\n", kvp.first.c_str(), interval > 0.0 ? (double)num_bytes / interval / 1000000.0 : 0.0);
+		}
+		std::fflush(stdout);
+
+		last_time = now;
+		last_bytes = bytes;
+	}
+}
+
+// Application entry point.
+int main(int argc, char** argv)
+{
+	// Initialize global variables.
+	g_exit_requested.store(false);
+
+	// Install signal handlers.
+	signal(SIGINT, signal_callback);
+	signal(SIGTERM, signal_callback);
+
+	// Default values for the command line arguments.
+	std::string discovery_mode_str("usb");
+	uint32_t discovery_mode = static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_USB);
+	std::string frame_format_str("thermography");
+	uint32_t frame_format = static_cast<uint32_t>(SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT);
+	int warm_up_sec = 5;
+	int duration_sec = 10;
+	std::string affinity_str("none");
+	std::string priority_str("none");
+	seekbench_sched_t sched;
+	std::string gradient_correction_str("camera setting");
+	int gradient_correction = -1;
+	std::string agc_mode_str("camera setting");
+	int agc_mode = -1;
+	int max_cameras_per_hub = 0;
+	int interval_sec = 0;
+
+	// Parse command line arguments.
+	for(int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		char ch = arg[0];
+		if(ch == '-' && strlen(arg) >= 2)
+		{
+			ch = arg[1];
+			const bool has_value = i < argc - 1;
+			switch(ch)
+			{
+				case 'm':
+					discovery_mode_str = has_value ? std::string(argv[i + 1]) : std::string();
+					if(discovery_mode_str == "usb")
+					{
+						discovery_mode = static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_USB);
+					}
+					else if(discovery_mode_str == "spi")
+					{
+						discovery_mode = static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_SPI);
+					}
+					else if(discovery_mode_str == "all")
+					{
+						discovery_mode = static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_USB) | static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_SPI);
+					}
+					else
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'f':
+					frame_format_str = has_value ? std::string(argv[i + 1]) : std::string();
+					frame_format = seekbench_parse_frame_formats(frame_format_str);
+					if(frame_format == 0)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'g':
+					gradient_correction_str = has_value ? std::string(argv[i + 1]) : std::string();
+					if(gradient_correction_str == "on")
+					{
+						gradient_correction = static_cast<int>(SEEKCAMERA_FILTER_STATE_ENABLED);
+					}
+					else if(gradient_correction_str == "off")
+					{
+						gradient_correction = static_cast<int>(SEEKCAMERA_FILTER_STATE_DISABLED);
+					}
+					else
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'e':
+					agc_mode_str = has_value ? std::string(argv[i + 1]) : std::string();
+					if(agc_mode_str == "linear")
+					{
+						agc_mode = static_cast<int>(SEEKCAMERA_AGC_MODE_LINEAR);
+					}
+					else if(agc_mode_str == "histeq")
+					{
+						agc_mode = static_cast<int>(SEEKCAMERA_AGC_MODE_HISTEQ);
+					}
+					else
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'w':
+					warm_up_sec = has_value ? std::atoi(argv[i + 1]) : -1;
+					if(warm_up_sec < 0)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'd':
+					duration_sec = has_value ? std::atoi(argv[i + 1]) : 0;
+					if(duration_sec <= 0)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'a':
+					affinity_str = has_value ? std::string(argv[i + 1]) : std::string();
+					sched.has_affinity = seekbench_parse_cpu_list(affinity_str, &sched.affinity);
+					if(!sched.has_affinity)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'p':
+					priority_str = has_value ? std::string(argv[i + 1]) : std::string();
+					sched.priority = std::atoi(priority_str.c_str());
+					if(sched.priority < 1 || sched.priority > 99)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'n':
+					max_cameras_per_hub = has_value ? std::atoi(argv[i + 1]) : -1;
+					if(max_cameras_per_hub < 0)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'i':
+					interval_sec = has_value ? std::atoi(argv[i + 1]) : -1;
+					if(interval_sec < 0)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'h':
+					print_usage();
+					return 0;
+				default:
+					break;
+			}
+		}
+	}
+
+	// Print the current settings.
+	std::cout
+		<< "seekcamera-bench starting\n"
+		<< "settings:\n"
+		<< "\t1) mode (-m):          " << discovery_mode_str << '\n'
+		<< "\t2) format (-f):        " << frame_format_str << '\n'
+		<< "\t3) warm up (-w):       " << warm_up_sec << " s\n"
+		<< "\t4) duration (-d):      " << duration_sec << " s\n"
+		<< "\t5) affinity (-a):      " << affinity_str << '\n'
+		<< "\t6) priority (-p):      " << priority_str << '\n'
+		<< "\t7) hub limit (-n):     " << (max_cameras_per_hub > 0 ? std::to_string(max_cameras_per_hub) : std::string("unlimited")) << '\n'
+		<< "\t8) interval (-i):      " << (interval_sec > 0 ? std::to_string(interval_sec) + " s" : std::string("off")) << '\n'
+		<< "\t9) gradient (-g):      " << gradient_correction_str << '\n'
+		<< "\t10) agc mode (-e):     " << agc_mode_str << std::endl;
+
+	seekbench_t bench;
+	bench.frame_format = frame_format;
+	bench.gradient_correction = gradient_correction;
+	bench.agc_mode = agc_mode;
+	bench.max_cameras_per_hub = max_cameras_per_hub;
+
+	// Create the camera manager.
+	// This is the structure that owns all Seek camera devices.
+	seekcamera_manager_t* manager = nullptr;
+	seekcamera_error_t status = seekcamera_manager_create(&manager, discovery_mode);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		std::cerr << "failed to create camera manager: " << seekcamera_error_get_str(status) << std::endl;
+		return 1;
+	}
+
+	// Register an event handler for the camera manager to be called whenever a camera event occurs.
+	status = seekcamera_manager_register_event_callback(manager, camera_event_callback, (void*)&bench);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		std::cerr << "failed to register camera event callback: " << seekcamera_error_get_str(status) << std::endl;
+		seekcamera_manager_destroy(&manager);
+		return 1;
+	}
+
+	// Let every camera connect and reach a steady frame rate before measuring.
+	// The SDK threads exist by then, so scheduling is applied to them at the end of the warm up.
+	seekbench_sleep(warm_up_sec);
+	if(sched.has_affinity || sched.priority > 0)
+	{
+		seekbench_apply_sched(sched);
+	}
+	const seekbench_usage_t start = seekbench_get_usage(&bench);
+	seekbench_measure(&bench, duration_sec, interval_sec);
+	const seekbench_usage_t end = seekbench_get_usage(&bench);
+
+	// Teardown the camera manager.
+	seekcamera_manager_destroy(&manager);
+
+	// Print the report.
+	seekbench_print_report(start, end);
+
+	return 0;
+}
@@ -0,0 +1,757 @@
+/*Copyright (c) [2020] [Seek Thermal, Inc.]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The Software may only be used in combination with Seek cores/products.
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:	 Seek Thermal SDK Demo
+ * Purpose:	 Shared memory frame ring used to publish frames to other processes
+ * Author:	 Seek Thermal, Inc.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#include "seekshm.h"
+
+// Structure that owns the writable side of a ring.
+struct seekshm_publisher_t
+{
+	char name[NAME_MAX];
+	int fd;
+	void* base;
+	size_t size;
+	seekshm_ring_header_t* ring;
+	int waiters_fd;
+	seekshm_waiters_header_t* waiters;
+};
+
+// Structure that owns the read-only side of a ring.
+struct seekshm_client_t
+{
+	const void* base;
+	size_t size;
+	const seekshm_ring_header_t* ring;
+	seekshm_waiters_header_t* waiters;
+	size_t max_data_size;
+	uint32_t last_futex_word;
+	uint64_t next_frame_index;
+	uint64_t num_acquired;
+	uint64_t num_dropped;
+};
+
+// Gets the number of bytes between the start of consecutive slots.
+static size_t seekshm_get_slot_stride(size_t max_data_size)
+{
+	const size_t size = sizeof(seekshm_slot_header_t) + sizeof(seekcamera_frame_header_t) + max_data_size;
+	return (size + SEEKSHM_SLOT_ALIGNMENT - 1) & ~((size_t)SEEKSHM_SLOT_ALIGNMENT - 1);
+}
+
+// Gets the offset of the first slot from the start of the region.
+static size_t seekshm_get_slots_offset(void)
+{
+	const size_t size = sizeof(seekshm_ring_header_t);
+	return (size + SEEKSHM_SLOT_ALIGNMENT - 1) & ~((size_t)SEEKSHM_SLOT_ALIGNMENT - 1);
+}
+
+// Gets a pointer to the slot at a given position in the ring.
+static uint8_t* seekshm_get_slot(const void* base, const seekshm_ring_header_t* ring, uint64_t position)
+{
+	const size_t index = (size_t)(position % ring->num_slots);
+	return (uint8_t*)base + seekshm_get_slots_offset() + index * ring->slot_stride;
+}
+
+// Gets the name of the waiters region of a named ring.
+static void seekshm_get_waiters_name(const char* name, char* waiters_name, size_t size)
+{
+	snprintf(waiters_name, size, "%s%s", name, SEEKSHM_WAITERS_SUFFIX);
+}
+
+// Maps a waiters region read-write, sizing it first if it was just created.
+static int seekshm_map_waiters(int fd, bool create, seekshm_waiters_header_t** waiters)
+{
+	if(create)
+	{
+		if(ftruncate(fd, (off_t)sizeof(seekshm_waiters_header_t)) != 0)
+		{
+			return -errno;
+		}
+	}
+	else
+	{
+		struct stat st;
+		if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(seekshm_waiters_header_t))
+		{
+			return -ENODATA;
+		}
+	}
+
+	void* base = mmap(NULL, sizeof(seekshm_waiters_header_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(base == MAP_FAILED)
+	{
+		return -errno;
+	}
+
+	*waiters = (seekshm_waiters_header_t*)base;
+	return 0;
+}
+
+// Wakes every process waiting on a futex word.
+// The futex is process-shared so the private flag must not be used.
+static void seekshm_futex_wake(uint32_t* word)
+{
+	syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+// Gets the time of the monotonic clock in milliseconds.
+static int64_t seekshm_get_time_ms(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// Waits on a futex word for as long as it holds the expected value.
+static int seekshm_futex_wait(const uint32_t* word, uint32_t expected, int timeout_ms)
+{
+	struct timespec timeout;
+	timeout.tv_sec = timeout_ms / 1000;
+	timeout.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+
+	const long result = syscall(SYS_futex, word, FUTEX_WAIT, expected, timeout_ms < 0 ? NULL : &timeout, NULL, 0);
+	return result == 0 ? 0 : -errno;
+}
+
+// Sizes and maps a newly created ring, then fills in its header.
+// The descriptor is owned by the caller.
+static int seekshm_publisher_map(seekshm_publisher_t* self, int fd, uint32_t num_slots, size_t slot_stride, size_t max_data_size, uint32_t frame_format)
+{
+	self->size = seekshm_get_slots_offset() + (size_t)num_slots * slot_stride;
+	if(ftruncate(fd, (off_t)self->size) != 0)
+	{
+		return -errno;
+	}
+
+	self->base = mmap(NULL, self->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(self->base == MAP_FAILED)
+	{
+		self->base = NULL;
+		return -errno;
+	}
+
+	// The region is zero filled by ftruncate so only the immutable fields are written.
+	// The magic is written last so clients never observe a partially initialized header.
+	self->ring = (seekshm_ring_header_t*)self->base;
+	self->ring->version = SEEKSHM_VERSION;
+	self->ring->num_slots = num_slots;
+	self->ring->slot_stride = (uint32_t)slot_stride;
+	self->ring->max_data_size = (uint32_t)max_data_size;
+	self->ring->frame_format = frame_format;
+	__atomic_store_n(&self->ring->magic, SEEKSHM_MAGIC, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+int seekshm_publisher_create(seekshm_publisher_t** publisher, const char* name, uint32_t num_slots, size_t max_data_size, uint32_t frame_format)
+{
+	if(publisher == NULL || name == NULL || num_slots == 0 || max_data_size == 0 || strlen(name) + strlen(SEEKSHM_WAITERS_SUFFIX) >= NAME_MAX)
+	{
+		return -EINVAL;
+	}
+
+	const size_t slot_stride = seekshm_get_slot_stride(max_data_size);
+	if(slot_stride > UINT32_MAX)
+	{
+		return -EINVAL;
+	}
+
+	seekshm_publisher_t* self = (seekshm_publisher_t*)calloc(1, sizeof(seekshm_publisher_t));
+	if(self == NULL)
+	{
+		return -ENOMEM;
+	}
+
+	strncpy(self->name, name, sizeof(self->name) - 1);
+	self->fd = -1;
+	self->waiters_fd = -1;
+
+	// Any stale ring left behind by a previous run is replaced.
+	shm_unlink(name);
+	const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if(fd < 0)
+	{
+		const int error = -errno;
+		free(self);
+		return error;
+	}
+
+	int result = seekshm_publisher_map(self, fd, num_slots, slot_stride, max_data_size, frame_format);
+	close(fd);
+
+	// Clients need write access to announce themselves, which the ring itself does not grant them.
+	if(result == 0)
+	{
+		char waiters_name[NAME_MAX] = { 0 };
+		seekshm_get_waiters_name(name, waiters_name, sizeof(waiters_name));
+		shm_unlink(waiters_name);
+		const int waiters_fd = shm_open(waiters_name, O_RDWR | O_CREAT | O_EXCL, 0644);
+		if(waiters_fd < 0)
+		{
+			result = -errno;
+		}
+		else
+		{
+			result = seekshm_map_waiters(waiters_fd, true, &self->waiters);
+			close(waiters_fd);
+		}
+	}
+
+	if(result != 0)
+	{
+		seekshm_publisher_destroy(&self);
+		return result;
+	}
+
+	*publisher = self;
+	return 0;
+}
+
+int seekshm_publisher_create_memfd(seekshm_publisher_t** publisher, const char* name, uint32_t num_slots, size_t max_data_size, uint32_t frame_format)
+{
+#if defined(SYS_memfd_create) && defined(MFD_ALLOW_SEALING) && defined(F_ADD_SEALS)
+	if(publisher == NULL || name == NULL || num_slots == 0 || max_data_size == 0)
+	{
+		return -EINVAL;
+	}
+
+	const size_t slot_stride = seekshm_get_slot_stride(max_data_size);
+	if(slot_stride > UINT32_MAX)
+	{
+		return -EINVAL;
+	}
+
+	seekshm_publisher_t* self = (seekshm_publisher_t*)calloc(1, sizeof(seekshm_publisher_t));
+	if(self == NULL)
+	{
+		return -ENOMEM;
+	}
+
+	// The name is only used for debugging (/proc/[pid]/fd); it is never linked into a filesystem.
+	self->waiters_fd = -1;
+	self->fd = (int)syscall(SYS_memfd_create, name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if(self->fd < 0)
+	{
+		const int error = -errno;
+		free(self);
+		return error;
+	}
+
+	int result = seekshm_publisher_map(self, self->fd, num_slots, slot_stride, max_data_size, frame_format);
+
+	// Seal the size so receivers can trust the mapping will never be truncated under them.
+	// Future writable mappings are refused as well where supported; the publisher mapping is already in place.
+	if(result == 0)
+	{
+		int seals = F_SEAL_SHRINK | F_SEAL_GROW;
+#	ifdef F_SEAL_FUTURE_WRITE
+		seals |= F_SEAL_FUTURE_WRITE;
+#	endif
+		if(fcntl(self->fd, F_ADD_SEALS, seals | F_SEAL_SEAL) != 0)
+		{
+			result = -errno;
+		}
+	}
+
+	// The waiters region stays writable for clients; only its size is sealed.
+	if(result == 0)
+	{
+		self->waiters_fd = (int)syscall(SYS_memfd_create, name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		if(self->waiters_fd < 0)
+		{
+			result = -errno;
+		}
+		else
+		{
+			result = seekshm_map_waiters(self->waiters_fd, true, &self->waiters);
+			if(result == 0 && fcntl(self->waiters_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+			{
+				result = -errno;
+			}
+		}
+	}
+
+	if(result != 0)
+	{
+		seekshm_publisher_destroy(&self);
+		return result;
+	}
+
+	*publisher = self;
+	return 0;
+#else
+	(void)publisher;
+	(void)name;
+	(void)num_slots;
+	(void)max_data_size;
+	(void)frame_format;
+	return -ENOSYS;
+#endif
+}
+
+void seekshm_publisher_destroy(seekshm_publisher_t** publisher)
+{
+	if(publisher == NULL || *publisher == NULL)
+	{
+		return;
+	}
+
+	// Creation may have failed part way, so every resource is checked.
+	// Clients still mapping the ring are told it is closed; blocked ones are woken so they can reopen it.
+	seekshm_publisher_t* self = *publisher;
+	if(self->ring != NULL)
+	{
+		__atomic_store_n(&self->ring->is_closed, 1, __ATOMIC_SEQ_CST);
+		__atomic_add_fetch(&self->ring->futex_word, 1, __ATOMIC_SEQ_CST);
+		seekshm_futex_wake(&self->ring->futex_word);
+	}
+	if(self->base != NULL)
+	{
+		munmap(self->base, self->size);
+	}
+	if(self->waiters != NULL)
+	{
+		munmap(self->waiters, sizeof(seekshm_waiters_header_t));
+	}
+	if(self->fd >= 0)
+	{
+		close(self->fd);
+		if(self->waiters_fd >= 0)
+		{
+			close(self->waiters_fd);
+		}
+	}
+	else
+	{
+		char waiters_name[NAME_MAX] = { 0 };
+		seekshm_get_waiters_name(self->name, waiters_name, sizeof(waiters_name));
+		shm_unlink(self->name);
+		shm_unlink(waiters_name);
+	}
+	free(self);
+	*publisher = NULL;
+}
+
+int seekshm_publisher_get_fd(const seekshm_publisher_t* publisher, int* fd)
+{
+	if(publisher == NULL || fd == NULL)
+	{
+		return -EINVAL;
+	}
+
+	if(publisher->fd < 0)
+	{
+		return -ENOTSUP;
+	}
+
+	// Reopen the memfd read-only so receivers cannot map it writable.
+	char path[64] = { 0 };
+	snprintf(path, sizeof(path), "/proc/self/fd/%d", publisher->fd);
+	*fd = open(path, O_RDONLY | O_CLOEXEC);
+	return *fd < 0 ? -errno : 0;
+}
+
+int seekshm_publisher_get_waiters_fd(const seekshm_publisher_t* publisher, int* fd)
+{
+	if(publisher == NULL || fd == NULL)
+	{
+		return -EINVAL;
+	}
+
+	if(publisher->waiters_fd < 0)
+	{
+		return -ENOTSUP;
+	}
+
+	// Clients must be able to update the waiter count, so this descriptor is writable.
+	char path[64] = { 0 };
+	snprintf(path, sizeof(path), "/proc/self/fd/%d", publisher->waiters_fd);
+	*fd = open(path, O_RDWR | O_CLOEXEC);
+	return *fd < 0 ? -errno : 0;
+}
+
+int seekshm_publisher_write(seekshm_publisher_t* publisher, const seekframe_t* frame)
+{
+	if(publisher == NULL || frame == NULL)
+	{
+		return -EINVAL;
+	}
+
+	const size_t data_size = seekframe_get_data_size(frame);
+	const size_t header_size = seekframe_get_header_size(frame);
+	if(data_size > publisher->ring->max_data_size)
+	{
+		return -EOVERFLOW;
+	}
+
+	seekshm_ring_header_t* ring = publisher->ring;
+	const uint64_t frame_index = ring->write_index;
+	uint8_t* slot = seekshm_get_slot(publisher->base, ring, frame_index);
+	seekshm_slot_header_t* slot_header = (seekshm_slot_header_t*)slot;
+
+	// Mark the slot as unstable before touching its contents.
+	const uint64_t sequence = slot_header->sequence;
+	__atomic_store_n(&slot_header->sequence, sequence + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	uint8_t* dst = slot + sizeof(seekshm_slot_header_t);
+	const size_t copy_header_size = header_size < sizeof(seekcamera_frame_header_t) ? header_size : sizeof(seekcamera_frame_header_t);
+	memcpy(dst, seekframe_get_header(frame), copy_header_size);
+	memcpy(dst + sizeof(seekcamera_frame_header_t), seekframe_get_data(frame), data_size);
+	slot_header->frame_index = frame_index;
+	slot_header->data_size = (uint32_t)data_size;
+
+	// Mark the slot as stable, then advertise it.
+	__atomic_store_n(&slot_header->sequence, sequence + 2, __ATOMIC_RELEASE);
+	__atomic_store_n(&ring->write_index, frame_index + 1, __ATOMIC_RELEASE);
+
+	// Skip the syscall while nobody is blocked.
+	// Both sides are sequentially consistent: either the publisher sees the waiter or the waiter sees the new word.
+	__atomic_add_fetch(&ring->futex_word, 1, __ATOMIC_SEQ_CST);
+	if(__atomic_load_n(&publisher->waiters->num_waiters, __ATOMIC_SEQ_CST) != 0)
+	{
+		seekshm_futex_wake(&ring->futex_word);
+	}
+
+	return 0;
+}
+
+int seekshm_client_open(seekshm_client_t** client, const char* name)
+{
+	if(client == NULL || name == NULL)
+	{
+		return -EINVAL;
+	}
+
+	if(strlen(name) + strlen(SEEKSHM_WAITERS_SUFFIX) >= NAME_MAX)
+	{
+		return -EINVAL;
+	}
+
+	const int fd = shm_open(name, O_RDONLY, 0);
+	if(fd < 0)
+	{
+		return -errno;
+	}
+
+	char waiters_name[NAME_MAX] = { 0 };
+	seekshm_get_waiters_name(name, waiters_name, sizeof(waiters_name));
+	const int waiters_fd = shm_open(waiters_name, O_RDWR, 0);
+	if(waiters_fd < 0)
+	{
+		const int error = -errno;
+		close(fd);
+		return error;
+	}
+
+	const int result = seekshm_client_open_fd(client, fd, waiters_fd);
+	close(waiters_fd);
+	close(fd);
+	return result;
+}
+
+int seekshm_client_open_fd(seekshm_client_t** client, int fd, int waiters_fd)
+{
+	if(client == NULL || fd < 0 || waiters_fd < 0)
+	{
+		return -EINVAL;
+	}
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(seekshm_ring_header_t))
+	{
+		return -ENODATA;
+	}
+
+	const void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if(base == MAP_FAILED)
+	{
+		return -errno;
+	}
+
+	// The layout is written by another process; it must describe slots that fit both the mapping and their frames.
+	const seekshm_ring_header_t* ring = (const seekshm_ring_header_t*)base;
+	if(__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != SEEKSHM_MAGIC ||
+		ring->version != SEEKSHM_VERSION ||
+		ring->num_slots == 0 ||
+		sizeof(seekshm_slot_header_t) + sizeof(seekcamera_frame_header_t) + (size_t)ring->max_data_size > ring->slot_stride ||
+		seekshm_get_slots_offset() + (size_t)ring->num_slots * ring->slot_stride > (size_t)st.st_size)
+	{
+		munmap((void*)base, (size_t)st.st_size);
+		return -EPROTO;
+	}
+
+	seekshm_waiters_header_t* waiters = NULL;
+	const int result = seekshm_map_waiters(waiters_fd, false, &waiters);
+	if(result != 0)
+	{
+		munmap((void*)base, (size_t)st.st_size);
+		return result;
+	}
+
+	seekshm_client_t* self = (seekshm_client_t*)calloc(1, sizeof(seekshm_client_t));
+	if(self == NULL)
+	{
+		munmap(waiters, sizeof(seekshm_waiters_header_t));
+		munmap((void*)base, (size_t)st.st_size);
+		return -ENOMEM;
+	}
+
+	self->base = base;
+	self->waiters = waiters;
+	self->size = (size_t)st.st_size;
+	self->ring = ring;
+	self->max_data_size = ring->max_data_size;
+	self->last_futex_word = __atomic_load_n(&ring->futex_word, __ATOMIC_ACQUIRE);
+
+	*client = self;
+	return 0;
+}
+
+void seekshm_client_close(seekshm_client_t** client)
+{
+	if(client == NULL || *client == NULL)
+	{
+		return;
+	}
+
+	seekshm_client_t* self = *client;
+	munmap(self->waiters, sizeof(seekshm_waiters_header_t));
+	munmap((void*)self->base, self->size);
+	free(self);
+	*client = NULL;
+}
+
+int seekshm_client_wait(seekshm_client_t* client, int timeout_ms)
+{
+	if(client == NULL)
+	{
+		return -EINVAL;
+	}
+
+	// Interrupted waits resume with whatever is left of the timeout rather than starting over.
+	const int64_t deadline_ms = seekshm_get_time_ms() + timeout_ms;
+
+	// Spurious wakeups are reported as new frames; acquire will filter them out.
+	for(;;)
+	{
+		if(__atomic_load_n(&client->ring->is_closed, __ATOMIC_ACQUIRE) != 0)
+		{
+			return -EPIPE;
+		}
+
+		const uint32_t word = __atomic_load_n(&client->ring->futex_word, __ATOMIC_ACQUIRE);
+		if(word != client->last_futex_word)
+		{
+			client->last_futex_word = word;
+			return 0;
+		}
+
+		int remaining_ms = -1;
+		if(timeout_ms >= 0)
+		{
+			const int64_t now_ms = seekshm_get_time_ms();
+			if(now_ms >= deadline_ms)
+			{
+				return -ETIMEDOUT;
+			}
+			remaining_ms = (int)(deadline_ms - now_ms);
+		}
+
+		// Announce the wait before checking the word one last time so the publisher cannot skip the wake.
+		__atomic_add_fetch(&client->waiters->num_waiters, 1, __ATOMIC_SEQ_CST);
+		int result = 0;
+		if(__atomic_load_n(&client->ring->futex_word, __ATOMIC_SEQ_CST) == word)
+		{
+			result = seekshm_futex_wait(&client->ring->futex_word, word, remaining_ms);
+		}
+		__atomic_sub_fetch(&client->waiters->num_waiters, 1, __ATOMIC_SEQ_CST);
+
+		if(result == -ETIMEDOUT)
+		{
+			return result;
+		}
+	}
+}
+
+int seekshm_client_acquire(seekshm_client_t* client, seekshm_view_t* view)
+{
+	if(client == NULL || view == NULL)
+	{
+		return -EINVAL;
+	}
+
+	const seekshm_ring_header_t* ring = client->ring;
+	const uint64_t write_index = __atomic_load_n(&ring->write_index, __ATOMIC_ACQUIRE);
+	if(write_index == 0 || write_index <= client->next_frame_index)
+	{
+		return -EAGAIN;
+	}
+
+	const uint8_t* slot = seekshm_get_slot(client->base, ring, write_index - 1);
+	const seekshm_slot_header_t* slot_header = (const seekshm_slot_header_t*)slot;
+	const uint64_t sequence = __atomic_load_n(&slot_header->sequence, __ATOMIC_ACQUIRE);
+	if((sequence & 1) != 0)
+	{
+		return -EAGAIN;
+	}
+
+	// A slot torn by a concurrent write can hold any size; never hand out a view beyond the slot.
+	const size_t data_size = slot_header->data_size;
+	if(data_size > client->max_data_size)
+	{
+		return -EAGAIN;
+	}
+
+	view->slot = slot_header;
+	view->sequence = sequence;
+	view->frame_index = slot_header->frame_index;
+	view->data_size = data_size;
+	view->header = (const seekcamera_frame_header_t*)(slot + sizeof(seekshm_slot_header_t));
+	view->data = slot + sizeof(seekshm_slot_header_t) + sizeof(seekcamera_frame_header_t);
+
+	// Frames published between two acquires were never seen by this client.
+	if(client->num_acquired > 0 && view->frame_index > client->next_frame_index)
+	{
+		client->num_dropped += view->frame_index - client->next_frame_index;
+	}
+	client->next_frame_index = view->frame_index + 1;
+	++client->num_acquired;
+
+	return 0;
+}
+
+bool seekshm_client_validate(const seekshm_client_t* client, const seekshm_view_t* view)
+{
+	if(client == NULL || view == NULL || view->slot == NULL)
+	{
+		return false;
+	}
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&view->slot->sequence, __ATOMIC_RELAXED) == view->sequence;
+}
+
+uint64_t seekshm_client_get_dropped(const seekshm_client_t* client)
+{
+	return client == NULL ? 0 : client->num_dropped;
+}
+
+int seekshm_send_fd(int socket_fd, int fd)
+{
+	// At least one byte of regular data must accompany the ancillary data.
+	char byte = 0;
+	struct iovec iov;
+	iov.iov_base = &byte;
+	iov.iov_len = sizeof(byte);
+
+	union
+	{
+		char buffer[CMSG_SPACE(sizeof(int))];
+		struct cmsghdr align;
+	} control;
+	memset(&control, 0, sizeof(control));
+
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control.buffer;
+	msg.msg_controllen = sizeof(control.buffer);
+
+	struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+	return sendmsg(socket_fd, &msg, MSG_NOSIGNAL) < 0 ? -errno : 0;
+}
+
+int seekshm_recv_fd(int socket_fd, int* fd)
+{
+	if(fd == NULL)
+	{
+		return -EINVAL;
+	}
+
+	char byte = 0;
+	struct iovec iov;
+	iov.iov_base = &byte;
+	iov.iov_len = sizeof(byte);
+
+	union
+	{
+		char buffer[CMSG_SPACE(sizeof(int))];
+		struct cmsghdr align;
+	} control;
+	memset(&control, 0, sizeof(control));
+
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control.buffer;
+	msg.msg_controllen = sizeof(control.buffer);
+
+	const ssize_t received = recvmsg(socket_fd, &msg, MSG_CMSG_CLOEXEC);
+	if(received < 0)
+	{
+		return -errno;
+	}
+
+	struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+	if(received == 0 || cmsg == NULL || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(sizeof(int)))
+	{
+		return -EPROTO;
+	}
+
+	memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+	return 0;
+}
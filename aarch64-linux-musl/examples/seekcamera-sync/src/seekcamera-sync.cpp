@@ -0,0 +1,637 @@
+/*Copyright (c) [2020] [Seek Thermal, Inc.]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The Software may only be used in combination with Seek cores/products.
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:	 Seek Thermal SDK Demo
+ * Purpose:	 Demonstrates how to align frames from multiple Seek Thermal Cameras
+ * Author:	 Seek Thermal, Inc.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// C includes
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// C++ includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Seek SDK includes
+#include "seekcamera/seekcamera.h"
+#include "seekcamera/seekcamera_manager.h"
+#include "seekframe/seekframe.h"
+
+// Enumerated type representing what to do when a camera has no frame within tolerance.
+enum seekgroup_missing_policy_t
+{
+	SEEKGROUP_MISSING_POLICY_WAIT = 0, // Keep waiting; incomplete sets are never emitted.
+	SEEKGROUP_MISSING_POLICY_DROP,     // Discard incomplete sets once they are too old.
+	SEEKGROUP_MISSING_POLICY_PARTIAL,  // Emit incomplete sets once they are too old.
+};
+
+// Structure representing a frame copied out of the SDK so it can be buffered.
+struct seekgroup_frame_t
+{
+	seekcamera_chipid_t cid;
+	uint64_t timestamp_ns;
+	seekcamera_frame_header_t header;
+	std::vector<float> data;
+};
+
+// Structure representing a set of frames captured at the same instant by all cameras of a group.
+// Cameras without a frame in a partial set have a null entry.
+struct seekgroup_frame_set_t
+{
+	std::vector<const seekgroup_frame_t*> frames;
+	uint64_t skew_ns;
+	bool is_partial;
+};
+
+// Structure representing the statistics of a camera group.
+struct seekgroup_stats_t
+{
+	uint64_t num_sets;
+	uint64_t num_partial_sets;
+	uint64_t num_dropped_sets;
+	uint64_t num_dropped_frames;
+	uint64_t total_skew_ns;
+	uint64_t max_skew_ns;
+};
+
+// Structure representing a group of cameras whose frames are aligned by timestamp.
+// Frames are buffered per camera and a set is emitted once every member has a frame within tolerance.
+// The callback runs with the group mutex held so that sets are delivered one at a time and in order; it must not call
+// any seekgroup function and must return quickly, since it blocks the frame callbacks of every member.
+struct seekgroup_t
+{
+	using callback_t = std::function<void(const seekgroup_frame_set_t&)>;
+
+	// Configuration
+	size_t num_members{};
+	uint64_t tolerance_ns{};
+	uint64_t max_wait_ns{};
+	size_t max_queue_depth{};
+	seekgroup_missing_policy_t policy{};
+	callback_t callback;
+
+	// State
+	std::mutex mutex;
+	std::vector<std::string> members;
+	std::vector<std::deque<seekgroup_frame_t>> queues;
+	seekgroup_stats_t stats{};
+};
+
+// Adds a camera to a group.
+// Returns false if the group is already full.
+bool seekgroup_add_member(seekgroup_t* group, const char* cid)
+{
+	std::lock_guard<std::mutex> lock(group->mutex);
+
+	const auto it = std::find(group->members.begin(), group->members.end(), std::string(cid));
+	if(it != group->members.end())
+	{
+		return true;
+	}
+
+	if(group->members.size() >= group->num_members)
+	{
+		return false;
+	}
+
+	group->members.emplace_back(cid);
+	group->queues.emplace_back();
+	return true;
+}
+
+// Removes a camera from a group and discards its buffered frames.
+void seekgroup_remove_member(seekgroup_t* group, const char* cid)
+{
+	std::lock_guard<std::mutex> lock(group->mutex);
+
+	const auto it = std::find(group->members.begin(), group->members.end(), std::string(cid));
+	if(it == group->members.end())
+	{
+		return;
+	}
+
+	const size_t index = (size_t)(it - group->members.begin());
+	group->members.erase(it);
+	group->queues.erase(group->queues.begin() + (std::ptrdiff_t)index);
+}
+
+// Emits a set made from the head of each selected queue and pops those heads.
+// Must be called with the group mutex held.
+static void seekgroup_emit_locked(seekgroup_t* group, const std::vector<bool>& selected, bool is_partial)
+{
+	seekgroup_frame_set_t set{};
+	set.is_partial = is_partial;
+	set.frames.resize(group->queues.size(), nullptr);
+
+	uint64_t min_ts = UINT64_MAX;
+	uint64_t max_ts = 0;
+	for(size_t i = 0; i < group->queues.size(); ++i)
+	{
+		if(selected[i])
+		{
+			const seekgroup_frame_t& frame = group->queues[i].front();
+			set.frames[i] = &frame;
+			min_ts = std::min(min_ts, frame.timestamp_ns);
+			max_ts = std::max(max_ts, frame.timestamp_ns);
+		}
+	}
+	set.skew_ns = max_ts >= min_ts ? max_ts - min_ts : 0;
+
+	++group->stats.num_sets;
+	group->stats.num_partial_sets += is_partial ? 1 : 0;
+	group->stats.total_skew_ns += set.skew_ns;
+	group->stats.max_skew_ns = std::max(group->stats.max_skew_ns, set.skew_ns);
+
+	if(group->callback)
+	{
+		group->callback(set);
+	}
+
+	for(size_t i = 0; i < group->queues.size(); ++i)
+	{
+		if(selected[i])
+		{
+			group->queues[i].pop_front();
+		}
+	}
+}
+
+// Emits every set that can be assembled from the buffered frames.
+// Must be called with the group mutex held.
+static void seekgroup_assemble_locked(seekgroup_t* group, uint64_t newest_ts)
+{
+	const size_t num_queues = group->queues.size();
+	if(num_queues < group->num_members)
+	{
+		return;
+	}
+
+	for(;;)
+	{
+		// Find the newest and oldest head frame among the non-empty queues.
+		uint64_t head_max = 0;
+		uint64_t head_min = UINT64_MAX;
+		size_t num_ready = 0;
+		for(const auto& queue : group->queues)
+		{
+			if(!queue.empty())
+			{
+				head_max = std::max(head_max, queue.front().timestamp_ns);
+				head_min = std::min(head_min, queue.front().timestamp_ns);
+				++num_ready;
+			}
+		}
+
+		if(num_ready == 0)
+		{
+			return;
+		}
+
+		// Heads that are too old to ever match the newest head are discarded.
+		if(num_ready == num_queues && head_max - head_min > group->tolerance_ns)
+		{
+			for(auto& queue : group->queues)
+			{
+				if(!queue.empty() && head_max - queue.front().timestamp_ns > group->tolerance_ns)
+				{
+					queue.pop_front();
+					++group->stats.num_dropped_frames;
+				}
+			}
+			continue;
+		}
+
+		// Every camera has a frame within tolerance.
+		if(num_ready == num_queues)
+		{
+			seekgroup_emit_locked(group, std::vector<bool>(num_queues, true), false);
+			continue;
+		}
+
+		// Some cameras have no frame yet; wait unless the oldest head has aged past the limit.
+		const uint64_t newest = std::max(newest_ts, head_max);
+		if(group->policy == SEEKGROUP_MISSING_POLICY_WAIT || newest - head_min <= group->max_wait_ns)
+		{
+			return;
+		}
+
+		std::vector<bool> selected(num_queues, false);
+		for(size_t i = 0; i < num_queues; ++i)
+		{
+			const auto& queue = group->queues[i];
+			selected[i] = !queue.empty() && queue.front().timestamp_ns - head_min <= group->tolerance_ns;
+		}
+
+		if(group->policy == SEEKGROUP_MISSING_POLICY_PARTIAL)
+		{
+			seekgroup_emit_locked(group, selected, true);
+		}
+		else
+		{
+			for(size_t i = 0; i < num_queues; ++i)
+			{
+				if(selected[i])
+				{
+					group->queues[i].pop_front();
+					++group->stats.num_dropped_frames;
+				}
+			}
+			++group->stats.num_dropped_sets;
+		}
+	}
+}
+
+// Buffers a frame for a group member and emits any sets that became complete.
+// The member is identified by the chip ID in the frame header so that the camera is never queried on the frame path.
+void seekgroup_push_frame(seekgroup_t* group, const seekframe_t* frame)
+{
+	// Frames may carry a shorter header than this build of the SDK declares; the missing fields read as zero.
+	seekgroup_frame_t entry{};
+	std::memcpy(&entry.header, seekframe_get_header(frame), std::min(sizeof(entry.header), seekframe_get_header_size(frame)));
+	std::memcpy(entry.cid, entry.header.chipid, sizeof(entry.cid) - 1);
+	entry.timestamp_ns = entry.header.timestamp_utc_ns;
+
+	const size_t width = seekframe_get_width(frame);
+	const size_t height = seekframe_get_height(frame);
+	entry.data.resize(width * height);
+	for(size_t y = 0; y < height; ++y)
+	{
+		std::memcpy(&entry.data[y * width], seekframe_get_row(frame, y), width * sizeof(float));
+	}
+
+	std::lock_guard<std::mutex> lock(group->mutex);
+
+	const auto it = std::find(group->members.begin(), group->members.end(), std::string(entry.cid));
+	if(it == group->members.end())
+	{
+		return;
+	}
+
+	auto& queue = group->queues[(size_t)(it - group->members.begin())];
+	const uint64_t timestamp_ns = entry.timestamp_ns;
+	queue.push_back(std::move(entry));
+
+	// Bound the memory used by a camera whose peers have stalled.
+	while(queue.size() > group->max_queue_depth)
+	{
+		queue.pop_front();
+		++group->stats.num_dropped_frames;
+	}
+
+	seekgroup_assemble_locked(group, timestamp_ns);
+}
+
+// Gets a snapshot of the group statistics.
+seekgroup_stats_t seekgroup_get_stats(seekgroup_t* group)
+{
+	std::lock_guard<std::mutex> lock(group->mutex);
+	return group->stats;
+}
+
+// Define the global variables
+static std::atomic<bool> g_exit_requested;         // Controls application shutdown.
+static std::map<seekcamera_t*, std::string> g_cids; // Chip IDs cached at connect; only used by camera manager callbacks.
+
+// Signal handler function.
+static void signal_callback(int signum)
+{
+	(void)signum;
+	std::cout << "\ncaught ctrl+c\n"
+			  << std::endl;
+	g_exit_requested.store(true);
+}
+
+// Prints the usage instructions.
+void print_usage()
+{
+	std::cout
+		<< "Allowed options:\n"
+		<< "\t-m : Discovery mode. Valid options: usb, spi, all (default: usb)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-n : Number of cameras in the group. Valid options: > 0 (default: 2)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-t : Alignment tolerance in milliseconds. Valid options: > 0 (default: 20)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-p : Missing frame policy. Valid options: wait, drop, partial (default: drop)\n"
+		<< "\t   : Required - No\n"
+		<< "\t-h : Displays this message\n"
+		<< "\t   : Required - No"
+		<< std::endl;
+}
+
+// Handles frame available events.
+void handle_camera_frame_available(seekcamera_t* camera, seekcamera_frame_t* camera_frame, void* user_data)
+{
+	(void)camera;
+	auto* group = (seekgroup_t*)user_data;
+
+	seekframe_t* frame = nullptr;
+	const seekcamera_error_t status = seekcamera_frame_get_frame_by_format(camera_frame, SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT, &frame);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		std::cerr << "failed to get frame: " << seekcamera_error_get_str(status) << std::endl;
+		return;
+	}
+
+	seekgroup_push_frame(group, frame);
+}
+
+// Gets the chip ID of a camera.
+// Cameras that are already connected are served from their cached chip ID; only newly connected cameras are queried.
+void get_cached_chipid(seekcamera_t* camera, seekcamera_chipid_t* cid)
+{
+	const auto iter = g_cids.find(camera);
+	if(iter != g_cids.end())
+	{
+		std::strncpy(*cid, iter->second.c_str(), sizeof(seekcamera_chipid_t) - 1);
+	}
+	else
+	{
+		seekcamera_get_chipid(camera, cid);
+	}
+}
+
+// Handles camera connect events.
+void handle_camera_connect(seekcamera_t* camera, seekcamera_error_t event_status, void* user_data)
+{
+	(void)event_status;
+	auto* group = (seekgroup_t*)user_data;
+
+	seekcamera_chipid_t cid{};
+	seekcamera_get_chipid(camera, &cid);
+	g_cids[camera] = cid;
+
+	if(!seekgroup_add_member(group, cid))
+	{
+		std::cerr << "group is full; ignoring camera (CID: " << cid << ")" << std::endl;
+		return;
+	}
+
+	seekcamera_error_t status = seekcamera_register_frame_available_callback(camera, handle_camera_frame_available, user_data);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		std::cerr << "failed to register frame callback: " << seekcamera_error_get_str(status) << std::endl;
+		seekgroup_remove_member(group, cid);
+		return;
+	}
+
+	status = seekcamera_capture_session_start(camera, SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		std::cerr << "failed to start capture session: " << seekcamera_error_get_str(status) << std::endl;
+		seekgroup_remove_member(group, cid);
+		return;
+	}
+}
+
+// Handles camera disconnect events.
+void handle_camera_disconnect(seekcamera_t* camera, seekcamera_error_t event_status, void* user_data)
+{
+	(void)event_status;
+	auto* group = (seekgroup_t*)user_data;
+
+	seekcamera_chipid_t cid{};
+	get_cached_chipid(camera, &cid);
+	g_cids.erase(camera);
+
+	if(seekcamera_is_active(camera))
+	{
+		seekcamera_capture_session_stop(camera);
+	}
+
+	seekgroup_remove_member(group, cid);
+}
+
+// Callback function for the camera manager; it fires whenever a camera event occurs.
+void camera_event_callback(seekcamera_t* camera, seekcamera_manager_event_t event, seekcamera_error_t event_status, void* user_data)
+{
+	seekcamera_chipid_t cid{};
+	get_cached_chipid(camera, &cid);
+	std::cout << seekcamera_manager_get_event_str(event) << " (CID: " << cid << ")" << std::endl;
+
+	// Handle the event type.
+	switch(event)
+	{
+		case SEEKCAMERA_MANAGER_EVENT_CONNECT:
+			handle_camera_connect(camera, event_status, user_data);
+			break;
+		case SEEKCAMERA_MANAGER_EVENT_DISCONNECT:
+			handle_camera_disconnect(camera, event_status, user_data);
+			break;
+		case SEEKCAMERA_MANAGER_EVENT_ERROR:
+			std::cerr << "unhandled camera error: (CID: " << cid << ")" << seekcamera_error_get_str(event_status) << std::endl;
+			break;
+		default:
+			break;
+	}
+}
+
+// Handles a complete (or partial) frame set.
+void handle_frame_set(const seekgroup_frame_set_t& set)
+{
+	std::cout << (set.is_partial ? "partial" : "aligned") << " frame set (skew: " << set.skew_ns / 1000 << " us):";
+	for(const seekgroup_frame_t* frame : set.frames)
+	{
+		if(frame != nullptr)
+		{
+			std::cout << ' ' << frame->cid << '=' << frame->header.thermography_spot_value;
+		}
+		else
+		{
+			std::cout << " missing";
+		}
+	}
+	std::cout << std::endl;
+}
+
+// Application entry point.
+int main(int argc, char** argv)
+{
+	// Initialize global variables.
+	g_exit_requested.store(false);
+
+	// Install signal handlers.
+	signal(SIGINT, signal_callback);
+	signal(SIGTERM, signal_callback);
+
+	// Default values for the command line arguments.
+	std::string discovery_mode_str("usb");
+	uint32_t discovery_mode = static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_USB);
+	int num_members = 2;
+	int tolerance_ms = 20;
+	std::string policy_str("drop");
+	seekgroup_missing_policy_t policy = SEEKGROUP_MISSING_POLICY_DROP;
+
+	// Parse command line arguments.
+	for(int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		char ch = arg[0];
+		if(ch == '-' && strlen(arg) >= 2)
+		{
+			ch = arg[1];
+			const bool has_value = i < argc - 1;
+			switch(ch)
+			{
+				case 'm':
+					discovery_mode_str = has_value ? std::string(argv[i + 1]) : std::string();
+					if(discovery_mode_str == "usb")
+					{
+						discovery_mode = static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_USB);
+					}
+					else if(discovery_mode_str == "spi")
+					{
+						discovery_mode = static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_SPI);
+					}
+					else if(discovery_mode_str == "all")
+					{
+						discovery_mode = static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_USB) | static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_SPI);
+					}
+					else
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'n':
+					num_members = has_value ? std::atoi(argv[i + 1]) : 0;
+					if(num_members <= 0)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 't':
+					tolerance_ms = has_value ? std::atoi(argv[i + 1]) : 0;
+					if(tolerance_ms <= 0)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'p':
+					policy_str = has_value ? std::string(argv[i + 1]) : std::string();
+					if(policy_str == "wait")
+					{
+						policy = SEEKGROUP_MISSING_POLICY_WAIT;
+					}
+					else if(policy_str == "drop")
+					{
+						policy = SEEKGROUP_MISSING_POLICY_DROP;
+					}
+					else if(policy_str == "partial")
+					{
+						policy = SEEKGROUP_MISSING_POLICY_PARTIAL;
+					}
+					else
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'h':
+					print_usage();
+					return 0;
+				default:
+					break;
+			}
+		}
+	}
+
+	// Print the current settings.
+	std::cout
+		<< "seekcamera-sync starting\n"
+		<< "settings:\n"
+		<< "\t1) mode (-m):          " << discovery_mode_str << '\n'
+		<< "\t2) cameras (-n):       " << num_members << '\n'
+		<< "\t3) tolerance (-t):     " << tolerance_ms << " ms\n"
+		<< "\t4) policy (-p):        " << policy_str << std::endl;
+
+	// Create the group.
+	// A frame set is given up on once the newest buffered frame is four tolerances past its oldest frame.
+	seekgroup_t group;
+	group.num_members = (size_t)num_members;
+	group.tolerance_ns = (uint64_t)tolerance_ms * 1000000ULL;
+	group.max_wait_ns = group.tolerance_ns * 4;
+	group.max_queue_depth = 8;
+	group.policy = policy;
+	group.callback = handle_frame_set;
+
+	// Create the camera manager.
+	// This is the structure that owns all Seek camera devices.
+	seekcamera_manager_t* manager = nullptr;
+	seekcamera_error_t status = seekcamera_manager_create(&manager, discovery_mode);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		std::cerr << "failed to create camera manager: " << seekcamera_error_get_str(status) << std::endl;
+		return 1;
+	}
+
+	// Register an event handler for the camera manager to be called whenever a camera event occurs.
+	status = seekcamera_manager_register_event_callback(manager, camera_event_callback, (void*)&group);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		std::cerr << "failed to register camera event callback: " << seekcamera_error_get_str(status) << std::endl;
+		seekcamera_manager_destroy(&manager);
+		return 1;
+	}
+
+	// Wait until told to stop.
+	while(!g_exit_requested.load())
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	// Teardown the camera manager.
+	seekcamera_manager_destroy(&manager);
+
+	// Print the group statistics.
+	const seekgroup_stats_t stats = seekgroup_get_stats(&group);
+	std::cout
+		<< "group statistics:\n"
+		<< "\tsets:           " << stats.num_sets << '\n'
+		<< "\tpartial sets:   " << stats.num_partial_sets << '\n'
+		<< "\tdropped sets:   " << stats.num_dropped_sets << '\n'
+		<< "\tdropped frames: " << stats.num_dropped_frames << '\n'
+		<< "\tmean skew:      " << (stats.num_sets > 0 ? stats.total_skew_ns / stats.num_sets / 1000 : 0) << " us\n"
+		<< "\tmax skew:       " << stats.max_skew_ns / 1000 << " us" << std::endl;
+
+	return 0;
+}
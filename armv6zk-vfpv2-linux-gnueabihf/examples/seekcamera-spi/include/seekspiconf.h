@@ -0,0 +1,133 @@
+/*Copyright (c) [2020] [Seek Thermal, Inc.]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The Software may only be used in combination with Seek cores/products.
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:	 Seek Thermal SDK Demo
+ * Purpose:	 SPI configuration used to generate seekspi.conf programmatically
+ * Author:	 Seek Thermal, Inc.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SEEKSPICONF_H__
+#define __SEEKSPICONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// Types
+//-----------------------------------------------------------------------------
+// Maximum number of cameras declared on a bus.
+#define SEEKSPICONF_MAX_CAMERAS 4
+
+// Default max_transfer_size; the default bufsiz of mainline spidev.
+#define SEEKSPICONF_DEFAULT_MAX_TRANSFER_SIZE 4096u
+
+// Default speed_hz; the minimum required to run a single camera at full frame rate.
+#define SEEKSPICONF_DEFAULT_SPEED_HZ 5140000u
+
+// Maximum speed_hz.
+#define SEEKSPICONF_MAX_SPEED_HZ 6000000u
+
+// Enumerated type representing how a control line is driven.
+typedef enum seekspiconf_ctrl_type_t
+{
+	SEEKSPICONF_CTRL_TYPE_NONE = 0,
+	SEEKSPICONF_CTRL_TYPE_GPIO,
+	SEEKSPICONF_CTRL_TYPE_IOCTL,
+} seekspiconf_ctrl_type_t;
+
+// Structure describing a frame_sync, reset_ctrl or power_ctrl node.
+// frame_sync only supports GPIO control and ignores the settling time.
+typedef struct seekspiconf_ctrl_t
+{
+	seekspiconf_ctrl_type_t type;
+	uint32_t gpio;             // GPIO number (SEEKSPICONF_CTRL_TYPE_GPIO)
+	uint32_t ioctl_request;    // Value of the custom _IOW request (SEEKSPICONF_CTRL_TYPE_IOCTL)
+	uint32_t ioctl_bytes;      // Length of the custom request in bytes (SEEKSPICONF_CTRL_TYPE_IOCTL)
+	uint32_t settling_time_ms; // Time to wait for the line to stabilize; 0-255
+	bool inverting;            // Whether to invert polarity
+} seekspiconf_ctrl_t;
+
+// Structure describing a camera node.
+typedef struct seekspiconf_camera_t
+{
+	uint32_t cs; // Chip select; the minor device number B in /dev/spidevA.B
+	seekspiconf_ctrl_t frame_sync;
+	seekspiconf_ctrl_t reset_ctrl;
+	seekspiconf_ctrl_t power_ctrl;
+} seekspiconf_camera_t;
+
+// Structure equivalent to the seekspi.conf schema.
+typedef struct seekspiconf_t
+{
+	uint32_t max_transfer_size; // Max number of bytes per SPI burst
+	bool camera_sync;           // Whether to synchronize transfers with the start of the FPA frame
+	uint32_t bus_num;           // Bus number; the major device number A in /dev/spidevA.B
+	uint32_t speed_hz;          // SCLK speed in Hz
+	size_t num_cameras;         // Number of valid entries in cameras
+	seekspiconf_camera_t cameras[SEEKSPICONF_MAX_CAMERAS];
+} seekspiconf_t;
+
+//-----------------------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------------------
+// Fills a configuration with the defaults of the seekspi.conf schema and a single camera on /dev/spidev0.0.
+void seekspiconf_init(
+	seekspiconf_t* config);
+
+// Checks a configuration against the ranges documented by the seekspi.conf schema.
+// Returns 0 if the configuration is valid or -EINVAL otherwise.
+int seekspiconf_validate(
+	const seekspiconf_t* config);
+
+// Gets the bufsiz module parameter of spidev, i.e. the largest max_transfer_size the running kernel accepts.
+// Returns 0 on success or a negative errno value on failure.
+int seekspiconf_get_spidev_bufsiz(
+	uint32_t* bufsiz);
+
+// Gets the path the SDK reads the configuration from (~/.seekthermal/seekspi.conf) and creates its directory.
+// Returns 0 on success or a negative errno value on failure.
+int seekspiconf_get_default_path(
+	char* path,
+	size_t path_size);
+
+// Writes a configuration as YAML.
+// The file is replaced atomically. With keep_backup, any previous file is kept with a .bak suffix; otherwise an
+// existing .bak file is left untouched.
+// Returns 0 on success or a negative errno value on failure.
+int seekspiconf_write(
+	const seekspiconf_t* config,
+	const char* path,
+	bool keep_backup);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __SEEKSPICONF_H__ */
@@ -0,0 +1,751 @@
+/*Copyright (c) [2020] [Seek Thermal, Inc.]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The Software may only be used in combination with Seek cores/products.
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:	 Seek Thermal SDK Demo
+ * Purpose:	 Demonstrates how to share frames from Seek Thermal Cameras with other processes
+ * Author:	 Seek Thermal, Inc.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "seekcamera/seekcamera.h"
+#include "seekcamera/seekcamera_manager.h"
+#include "seekshm.h"
+
+// Options
+#define NUM_MAX_DEVICES       64
+#define MAX_RING_NAME_LENGTH  64
+#define DEFAULT_NUM_SLOTS     4
+
+// Structure holding the context for a Seek camera and its shared memory ring.
+typedef struct samplectx_t
+{
+	bool is_free;
+	bool is_live;
+	seekcamera_t* camera;
+	seekcamera_chipid_t cid;
+	pthread_mutex_t mutex;
+	seekshm_publisher_t* publisher;
+} samplectx_t;
+
+// Define the global variables.
+volatile bool g_keep_running = true;
+static uint32_t g_num_slots = DEFAULT_NUM_SLOTS;
+static const char* g_socket_path = NULL;
+static samplectx_t g_ctx_pool[NUM_MAX_DEVICES];
+
+// Signal handler function.
+static void signal_callback(int signum)
+{
+	(void)signum;
+
+	fprintf(stdout, "\nCaught Ctrl+C\n\n");
+	g_keep_running = false;
+}
+
+// Prints the usage instructions.
+void print_usage()
+{
+	fprintf(stdout, "Allowed options\n");
+	fprintf(stdout, "\t-m : Discovery mode. Valid options: usb, spi, all (default: usb)\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-n : Number of frame slots in each shared memory ring. Valid options: > 0 (default: %d)\n", DEFAULT_NUM_SLOTS);
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-r : Reads frames published by another instance for the given camera chip ID\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-s : Unix socket used to hand out memfd backed rings instead of named shared memory\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-h : Displays this message\n");
+	fprintf(stdout, "\t   : Required - No\n");
+}
+
+// Gets the name of the shared memory ring associated with a camera.
+void get_ring_name(const char* cid, char* name, size_t name_size)
+{
+	snprintf(name, name_size, "/seekcamera-%s", cid);
+}
+
+// Callback function for a particular Seek camera.
+// This function fires whenever a frame is available.
+void frame_available_callback(seekcamera_t* camera, seekcamera_frame_t* camera_frame, void* user_data)
+{
+	(void)camera;
+	samplectx_t* ctx = (samplectx_t*)user_data;
+
+	seekframe_t* frame = NULL;
+	const seekcamera_error_t status = seekcamera_frame_get_frame_by_format(
+		camera_frame,
+		SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT,
+		&frame);
+
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stderr, "failed to get thermal frame: %s (%s)\n", ctx->cid, seekcamera_error_get_str(status));
+		return;
+	}
+
+	pthread_mutex_lock(&ctx->mutex);
+
+	// The ring is created on the first frame because that is when the frame size is known.
+	if(ctx->is_live && ctx->publisher == NULL)
+	{
+		char name[MAX_RING_NAME_LENGTH] = { 0 };
+		get_ring_name(ctx->cid, name, sizeof(name));
+
+		// Rings handed out over a socket are anonymous; others are reachable by name.
+		const int result = g_socket_path != NULL ?
+			seekshm_publisher_create_memfd(&ctx->publisher, name, g_num_slots, seekframe_get_data_size(frame), SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT) :
+			seekshm_publisher_create(&ctx->publisher, name, g_num_slots, seekframe_get_data_size(frame), SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT);
+
+		if(result == 0)
+		{
+			fprintf(stdout, "created shared memory ring: %s (%s, %u slots)\n", ctx->cid, name, g_num_slots);
+		}
+		else
+		{
+			fprintf(stderr, "failed to create shared memory ring: %s (%s)\n", ctx->cid, strerror(-result));
+			ctx->is_live = false;
+		}
+	}
+
+	if(ctx->publisher != NULL)
+	{
+		const int result = seekshm_publisher_write(ctx->publisher, frame);
+		if(result != 0)
+		{
+			fprintf(stderr, "failed to publish frame: %s (%s)\n", ctx->cid, strerror(-result));
+		}
+	}
+
+	pthread_mutex_unlock(&ctx->mutex);
+}
+
+// Finds the context associated with a camera.
+// Returns NULL if the camera is not associated with any context.
+samplectx_t* find_ctx(const seekcamera_t* camera)
+{
+	for(int i = 0; i < NUM_MAX_DEVICES; ++i)
+	{
+		if(!g_ctx_pool[i].is_free && g_ctx_pool[i].camera == camera)
+		{
+			return &(g_ctx_pool[i]);
+		}
+	}
+
+	return NULL;
+}
+
+// Gets the chip ID of a camera.
+// Cameras that are already tracked are served from their cached chip ID; only newly connected cameras are queried.
+void get_cached_chipid(seekcamera_t* camera, seekcamera_chipid_t* cid)
+{
+	const samplectx_t* ctx = find_ctx(camera);
+	if(ctx != NULL)
+	{
+		memcpy(*cid, ctx->cid, sizeof(seekcamera_chipid_t));
+	}
+	else
+	{
+		seekcamera_get_chipid(camera, cid);
+	}
+}
+
+// Handles camera connect events.
+void handle_camera_connect(seekcamera_t* camera, seekcamera_error_t event_status, void* user_data)
+{
+	(void)event_status;
+	(void)user_data;
+
+	// Each camera is associated with an application level context structure.
+	// On each connect, the available context resource pool is searched to find a free context.
+	samplectx_t* ctx = NULL;
+	for(int i = 0; i < NUM_MAX_DEVICES && (ctx == NULL); ++i)
+	{
+		if(g_ctx_pool[i].is_free)
+		{
+			ctx = &(g_ctx_pool[i]);
+		}
+	}
+
+	// The context pool is exhausted.
+	// This is a limitation of the sample application -- not a limitation of the Seek API.
+	if(ctx == NULL)
+	{
+		fprintf(stderr, "camera context pool is exhausted\n");
+		return;
+	}
+
+	// Reset the context values to be assocated with this camera.
+	pthread_mutex_lock(&ctx->mutex);
+	ctx->is_free = false;
+	ctx->is_live = true;
+	ctx->camera = camera;
+	seekcamera_get_chipid(camera, &ctx->cid);
+	pthread_mutex_unlock(&ctx->mutex);
+
+	seekcamera_error_t status = seekcamera_register_frame_available_callback(
+		camera,
+		frame_available_callback,
+		(void*)ctx);
+
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stderr, "failed to register camera callback: %s (%s)\n", ctx->cid, seekcamera_error_get_str(status));
+		return;
+	}
+
+	// Start the capture session.
+	// Thermography is published as single precision floating point values.
+	status = seekcamera_capture_session_start(camera, SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT);
+	if(status == SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stdout, "started capture session: %s\n", ctx->cid);
+	}
+	else
+	{
+		fprintf(stderr, "failed to start capture session: %s (%s)\n", ctx->cid, seekcamera_error_get_str(status));
+		pthread_mutex_lock(&ctx->mutex);
+		ctx->is_live = false;
+		pthread_mutex_unlock(&ctx->mutex);
+	}
+}
+
+// Handles camera disconnect events.
+void handle_camera_disconnect(seekcamera_t* camera, seekcamera_error_t event_status, void* user_data)
+{
+	(void)event_status;
+	(void)user_data;
+
+	// Search the resource pool for the context associated with the camera.
+	samplectx_t* ctx = find_ctx(camera);
+	if(ctx == NULL)
+	{
+		fprintf(stderr, "failed to find associated context\n");
+		return;
+	}
+
+	if(ctx->is_live)
+	{
+		seekcamera_capture_session_stop(camera);
+	}
+
+	// Unlink the ring; clients that still have it mapped keep their mapping until they close it.
+	pthread_mutex_lock(&ctx->mutex);
+	seekshm_publisher_destroy(&ctx->publisher);
+	ctx->is_free = true;
+	ctx->is_live = false;
+	ctx->camera = NULL;
+	pthread_mutex_unlock(&ctx->mutex);
+}
+
+// Callback function for the Seek camera manager.
+// This function fires whenever a camera event occurs for a given camera manager context.
+void camera_event_callback(seekcamera_t* camera, seekcamera_manager_event_t event, seekcamera_error_t event_status, void* user_data)
+{
+	seekcamera_chipid_t cid;
+	get_cached_chipid(camera, &cid);
+
+	fprintf(stdout, "%s: %s\n", seekcamera_manager_get_event_str(event), cid);
+
+	switch(event)
+	{
+		case SEEKCAMERA_MANAGER_EVENT_CONNECT:
+			handle_camera_connect(camera, event_status, user_data);
+			break;
+		case SEEKCAMERA_MANAGER_EVENT_DISCONNECT:
+			handle_camera_disconnect(camera, event_status, user_data);
+			break;
+		case SEEKCAMERA_MANAGER_EVENT_ERROR:
+			fprintf(stderr, "encountered unexpected error: %s (%s)\n", cid, seekcamera_error_get_str(event_status));
+			break;
+		default:
+			break;
+	}
+}
+
+// Fills a Unix domain socket address.
+bool get_socket_address(const char* path, struct sockaddr_un* address)
+{
+	memset(address, 0, sizeof(*address));
+	address->sun_family = AF_UNIX;
+	if(strlen(path) >= sizeof(address->sun_path))
+	{
+		return false;
+	}
+	strncpy(address->sun_path, path, sizeof(address->sun_path) - 1);
+	return true;
+}
+
+// Creates the listening socket used to hand out ring descriptors.
+int create_listen_socket(const char* path)
+{
+	struct sockaddr_un address;
+	if(!get_socket_address(path, &address))
+	{
+		return -ENAMETOOLONG;
+	}
+
+	const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(fd < 0)
+	{
+		return -errno;
+	}
+
+	unlink(path);
+	if(bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(fd, NUM_MAX_DEVICES) != 0)
+	{
+		const int error = -errno;
+		close(fd);
+		return error;
+	}
+
+	return fd;
+}
+
+// Serves a single descriptor request.
+// The client sends the chip ID of a camera and receives a read-only descriptor for its ring followed by a
+// read-write descriptor for the waiters region of the ring.
+// The connection is closed without a descriptor if the camera is unknown or not yet streaming.
+void serve_ring_request(int listen_fd)
+{
+	const int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+	if(fd < 0)
+	{
+		return;
+	}
+
+	// Do not let a stalled client block the main thread.
+	struct timeval timeout = { 1, 0 };
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	seekcamera_chipid_t cid = { 0 };
+	const ssize_t length = recv(fd, cid, sizeof(cid) - 1, 0);
+	if(length > 0)
+	{
+		cid[strcspn(cid, "\r\n")] = '\0';
+
+		int ring_fd = -1;
+		int waiters_fd = -1;
+		for(int i = 0; i < NUM_MAX_DEVICES && ring_fd < 0; ++i)
+		{
+			samplectx_t* ctx = &(g_ctx_pool[i]);
+			pthread_mutex_lock(&ctx->mutex);
+			if(!ctx->is_free && ctx->publisher != NULL && strcmp(ctx->cid, cid) == 0)
+			{
+				seekshm_publisher_get_fd(ctx->publisher, &ring_fd);
+				seekshm_publisher_get_waiters_fd(ctx->publisher, &waiters_fd);
+			}
+			pthread_mutex_unlock(&ctx->mutex);
+		}
+
+		if(ring_fd >= 0 && waiters_fd >= 0)
+		{
+			int result = seekshm_send_fd(fd, ring_fd);
+			if(result == 0)
+			{
+				result = seekshm_send_fd(fd, waiters_fd);
+			}
+			if(result == 0)
+			{
+				fprintf(stdout, "sent shared memory ring: %s\n", cid);
+			}
+			else
+			{
+				fprintf(stderr, "failed to send shared memory ring: %s (%s)\n", cid, strerror(-result));
+			}
+		}
+		else
+		{
+			fprintf(stderr, "no shared memory ring for request: %s\n", cid);
+		}
+
+		if(ring_fd >= 0)
+		{
+			close(ring_fd);
+		}
+		if(waiters_fd >= 0)
+		{
+			close(waiters_fd);
+		}
+	}
+
+	close(fd);
+}
+
+// Requests the descriptors of a memfd backed ring and its waiters region from another instance of this application.
+int request_ring_fd(const char* path, const char* cid, int* ring_fd, int* waiters_fd)
+{
+	struct sockaddr_un address;
+	if(!get_socket_address(path, &address))
+	{
+		return -ENAMETOOLONG;
+	}
+
+	const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(fd < 0)
+	{
+		return -errno;
+	}
+
+	int result = 0;
+	if(connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0 || send(fd, cid, strlen(cid), MSG_NOSIGNAL) < 0)
+	{
+		result = -errno;
+	}
+	else
+	{
+		result = seekshm_recv_fd(fd, ring_fd);
+		if(result == 0)
+		{
+			result = seekshm_recv_fd(fd, waiters_fd);
+			if(result != 0)
+			{
+				close(*ring_fd);
+				*ring_fd = -1;
+			}
+		}
+	}
+
+	close(fd);
+	return result;
+}
+
+// Opens the ring of a camera, either by name or through the socket of the publisher.
+int open_ring(const char* cid, const char* name, seekshm_client_t** client)
+{
+	if(g_socket_path == NULL)
+	{
+		return seekshm_client_open(client, name);
+	}
+
+	// The ring is anonymous so it has to be handed over by the publisher.
+	int ring_fd = -1;
+	int waiters_fd = -1;
+	int result = request_ring_fd(g_socket_path, cid, &ring_fd, &waiters_fd);
+	if(result == 0)
+	{
+		result = seekshm_client_open_fd(client, ring_fd, waiters_fd);
+		close(waiters_fd);
+		close(ring_fd);
+	}
+
+	return result;
+}
+
+// Reads frames published by another instance of this application.
+// Frames are consumed in place; no copy is made.
+int run_reader(const char* cid)
+{
+	char name[MAX_RING_NAME_LENGTH] = { 0 };
+	get_ring_name(cid, name, sizeof(name));
+
+	seekshm_client_t* client = NULL;
+	int result = open_ring(cid, name, &client);
+	if(result != 0)
+	{
+		fprintf(stderr, "failed to open shared memory ring: %s (%s)\n", name, strerror(-result));
+		return 1;
+	}
+
+	fprintf(stdout, "opened shared memory ring: %s\n", name);
+
+	while(g_keep_running)
+	{
+		result = seekshm_client_wait(client, 1000);
+		if(result == -EPIPE)
+		{
+			// The publisher destroyed the ring, e.g. because the camera disconnected.
+			// A new ring is created once the camera streams again, so keep trying to open it.
+			fprintf(stdout, "shared memory ring closed: %s\n", name);
+			seekshm_client_close(&client);
+			while(g_keep_running && open_ring(cid, name, &client) != 0)
+			{
+				sleep(1);
+			}
+
+			if(client != NULL)
+			{
+				fprintf(stdout, "reopened shared memory ring: %s\n", name);
+			}
+			continue;
+		}
+
+		if(result != 0)
+		{
+			continue;
+		}
+
+		seekshm_view_t view;
+		if(seekshm_client_acquire(client, &view) != 0)
+		{
+			continue;
+		}
+
+		// Read what is needed directly from shared memory.
+		// The header is written by another process and may be torn; the center pixel must lie within the view.
+		const seekcamera_frame_header_t* header = view.header;
+		const uint16_t width = header->width;
+		const uint16_t height = header->height;
+		const size_t center_offset = (size_t)(height / 2) * header->line_stride + (size_t)(width / 2) * sizeof(float);
+		if(width == 0 || height == 0 || center_offset + sizeof(float) > view.data_size)
+		{
+			continue;
+		}
+
+		float center = 0.0f;
+		memcpy(&center, (const uint8_t*)view.data + center_offset, sizeof(float));
+		const float spot = header->thermography_spot_value;
+
+		// The publisher may have lapped this reader while the frame was being read.
+		if(!seekshm_client_validate(client, &view))
+		{
+			fprintf(stderr, "frame overwritten while reading: %s (index: %llu)\n", cid, (unsigned long long)view.frame_index);
+			continue;
+		}
+
+		fprintf(stdout, "frame available: %s (index: %llu, size: %ux%u, center: %.1f, spot: %.1f, dropped: %llu)\n",
+			cid,
+			(unsigned long long)view.frame_index,
+			width,
+			height,
+			center,
+			spot,
+			(unsigned long long)seekshm_client_get_dropped(client));
+	}
+
+	seekshm_client_close(&client);
+	return 0;
+}
+
+// Application entry point.
+int main(int argc, char** argv)
+{
+	// Install signal handlers.
+	signal(SIGINT, signal_callback);
+	signal(SIGTERM, signal_callback);
+
+	// Default values for the command line arguments.
+	char* discovery_mode_str = "usb";
+	seekcamera_io_type_t discovery_mode = (uint32_t)SEEKCAMERA_IO_TYPE_USB;
+	const char* reader_cid = NULL;
+
+	// Parse command line arguments.
+	for(int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		char ch = arg[0];
+		if(ch == '-' && strlen(arg) >= 2)
+		{
+			ch = arg[1];
+			switch(ch)
+			{
+				case 'm':
+					if(i < argc - 1)
+					{
+						discovery_mode_str = argv[i + 1];
+						if(strcmp(discovery_mode_str, "usb") == 0)
+						{
+							discovery_mode = (uint32_t)SEEKCAMERA_IO_TYPE_USB;
+						}
+						else if(strcmp(discovery_mode_str, "spi") == 0)
+						{
+							discovery_mode = (uint32_t)SEEKCAMERA_IO_TYPE_SPI;
+						}
+						else if(strcmp(discovery_mode_str, "all") == 0)
+						{
+							discovery_mode = (uint32_t)SEEKCAMERA_IO_TYPE_USB | (uint32_t)SEEKCAMERA_IO_TYPE_SPI;
+						}
+						else
+						{
+							print_usage();
+							return 1;
+						}
+					}
+					else
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'n':
+					if(i < argc - 1 && atoi(argv[i + 1]) > 0)
+					{
+						g_num_slots = (uint32_t)atoi(argv[i + 1]);
+					}
+					else
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'r':
+					if(i < argc - 1)
+					{
+						reader_cid = argv[i + 1];
+					}
+					else
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 's':
+					if(i < argc - 1)
+					{
+						g_socket_path = argv[i + 1];
+					}
+					else
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'h':
+					print_usage();
+					return 0;
+				default:
+					break;
+			}
+		}
+	}
+
+	if(reader_cid != NULL)
+	{
+		fprintf(stdout, "seekcamera-shm starting\n");
+		fprintf(stdout, "settings\n");
+		fprintf(stdout, "\t1) reader (-r): %s\n", reader_cid);
+		fprintf(stdout, "\t2) socket (-s): %s\n", g_socket_path != NULL ? g_socket_path : "none");
+		fflush(stdout);
+		return run_reader(reader_cid);
+	}
+
+	fprintf(stdout, "seekcamera-shm starting\n");
+	fprintf(stdout, "settings\n");
+	fprintf(stdout, "\t1) mode (-m): %s\n", discovery_mode_str);
+	fprintf(stdout, "\t2) slots (-n): %u\n", g_num_slots);
+	fprintf(stdout, "\t3) socket (-s): %s\n", g_socket_path != NULL ? g_socket_path : "none");
+	fflush(stdout);
+
+
+	// Setup the global context pool.
+	for(int i = 0; i < NUM_MAX_DEVICES; ++i)
+	{
+		g_ctx_pool[i].is_free = true;
+		g_ctx_pool[i].is_live = false;
+		g_ctx_pool[i].camera = NULL;
+		g_ctx_pool[i].publisher = NULL;
+		pthread_mutex_init(&g_ctx_pool[i].mutex, NULL);
+	}
+
+	// Create the camera manager.
+	// This is the structure that owns all Seek camera devices.
+	seekcamera_manager_t* manager = NULL;
+	seekcamera_error_t status = seekcamera_manager_create(&manager, discovery_mode);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stderr, "failed to create camera manager: %s\n", seekcamera_error_get_str(status));
+		return 1;
+	}
+
+	// Register an event handler for the camera manager.
+	status = seekcamera_manager_register_event_callback(manager, camera_event_callback, NULL);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stderr, "failed to register camera event callback: %s\n", seekcamera_error_get_str(status));
+		seekcamera_manager_destroy(&manager);
+		return 1;
+	}
+
+	// Create the socket used to hand out ring descriptors.
+	int listen_fd = -1;
+	if(g_socket_path != NULL)
+	{
+		listen_fd = create_listen_socket(g_socket_path);
+		if(listen_fd < 0)
+		{
+			fprintf(stderr, "failed to create socket: %s (%s)\n", g_socket_path, strerror(-listen_fd));
+			seekcamera_manager_destroy(&manager);
+			return 1;
+		}
+	}
+
+	// Descriptor requests are served on the main thread.
+	while(g_keep_running)
+	{
+		if(listen_fd < 0)
+		{
+			usleep(1000 * 1000);
+			continue;
+		}
+
+		struct pollfd pfd = { listen_fd, POLLIN, 0 };
+		if(poll(&pfd, 1, 1000) > 0 && (pfd.revents & POLLIN) != 0)
+		{
+			serve_ring_request(listen_fd);
+		}
+	}
+
+	if(listen_fd >= 0)
+	{
+		close(listen_fd);
+		unlink(g_socket_path);
+	}
+
+	// Cleanup the camera manager.
+	// Cameras will be disconnected and invalidated.
+	status = seekcamera_manager_destroy(&manager);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stderr, "failed to free camera manager: %s\n", seekcamera_error_get_str(status));
+	}
+
+	// Unlink any rings that are still published.
+	for(int i = 0; i < NUM_MAX_DEVICES; ++i)
+	{
+		seekshm_publisher_destroy(&g_ctx_pool[i].publisher);
+		pthread_mutex_destroy(&g_ctx_pool[i].mutex);
+	}
+
+	fprintf(stdout, "done\n");
+
+	return status == SEEKCAMERA_SUCCESS ? 0 : 1;
+}
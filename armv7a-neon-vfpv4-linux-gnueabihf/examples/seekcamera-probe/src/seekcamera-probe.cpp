@@ -36,8 +36,10 @@ SOFTWARE.
 
 // C++ includes
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -52,6 +54,8 @@ SOFTWARE.
 // Structure representing a camera probing interface.
 struct seekprober_t
 {
+	using clock_t = std::chrono::steady_clock;
+
 	// Structure representing a camera probe metric.
 	struct metric_t
 	{
@@ -62,8 +66,30 @@ struct seekprober_t
 		seekcamera_io_properties_t io;
 	};
 
+	// Structure representing the startup timeline of a camera.
+	// Each phase is the time elapsed since the camera manager started to be created.
+	struct timeline_t
+	{
+		seekcamera_chipid_t cid;
+		seekcamera_t* camera;
+		clock_t::time_point start;
+		clock_t::duration connect;
+		clock_t::duration identify;
+		clock_t::duration session_start;
+		std::atomic<bool> has_first_frame;
+		clock_t::duration first_frame;
+		seekcamera_error_t session_status;
+	};
+
 	std::mutex metrics_mutex;
 	std::vector<metric_t> metrics;
+
+	// Startup timeline data
+	bool is_timeline_enabled{};
+	clock_t::time_point start;
+	clock_t::duration manager_create{};
+	std::vector<std::unique_ptr<timeline_t>> timelines;
+	std::vector<std::thread> session_threads;
 };
 
 // Gathers camera info and stores it as a probe metric.
@@ -224,6 +250,106 @@ void seekprober_print_metrics(seekprober_t* prober)
 	}
 }
 
+// Handles the first frame of a camera whose startup timeline is being measured.
+void seekprober_handle_first_frame(seekcamera_t* camera, seekcamera_frame_t* camera_frame, void* user_data)
+{
+	(void)camera;
+	(void)camera_frame;
+
+	auto* timeline = (seekprober_t::timeline_t*)user_data;
+	if(!timeline->has_first_frame.load())
+	{
+		timeline->first_frame = seekprober_t::clock_t::now() - timeline->start;
+		timeline->has_first_frame.store(true);
+	}
+}
+
+// Starts the capture session of a camera and records when it started.
+// This runs on a dedicated thread per camera so that a slow session start does not hold up
+// the camera manager while it brings up the remaining cameras.
+void seekprober_start_session(seekprober_t::timeline_t* timeline)
+{
+	seekcamera_error_t status = seekcamera_register_frame_available_callback(timeline->camera, seekprober_handle_first_frame, (void*)timeline);
+	if(status == SEEKCAMERA_SUCCESS)
+	{
+		status = seekcamera_capture_session_start(timeline->camera, SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT);
+	}
+
+	timeline->session_start = seekprober_t::clock_t::now() - timeline->start;
+	timeline->session_status = status;
+}
+
+// Records that a camera connected and starts measuring the rest of its startup timeline.
+void seekprober_add_timeline(seekprober_t* prober, seekcamera_t* camera, seekprober_t::clock_t::time_point connect_time)
+{
+	std::unique_ptr<seekprober_t::timeline_t> timeline(new seekprober_t::timeline_t());
+	timeline->camera = camera;
+	timeline->start = prober->start;
+	timeline->connect = connect_time - prober->start;
+	timeline->identify = seekprober_t::clock_t::now() - prober->start;
+	timeline->has_first_frame.store(false);
+	timeline->session_status = SEEKCAMERA_SUCCESS;
+	seekcamera_get_chipid(camera, &(timeline->cid));
+
+	// Enter critical section.
+	std::lock_guard<std::mutex> lock(prober->metrics_mutex);
+	prober->session_threads.emplace_back(seekprober_start_session, timeline.get());
+	prober->timelines.push_back(std::move(timeline));
+}
+
+// Waits for every pending capture session start to complete.
+void seekprober_join_sessions(seekprober_t* prober)
+{
+	std::vector<std::thread> threads;
+	{
+		std::lock_guard<std::mutex> lock(prober->metrics_mutex);
+		threads.swap(prober->session_threads);
+	}
+
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+// Prints the startup timeline of each camera to the console.
+void seekprober_print_timelines(seekprober_t* prober)
+{
+	// Enter critical section.
+	std::lock_guard<std::mutex> lock(prober->metrics_mutex);
+
+	auto to_ms = [](seekprober_t::clock_t::duration duration) {
+		return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+	};
+
+	auto print_table_separator_line = []() {
+		std::fprintf(stdout, "+-------------------------------------------------------------------------+\n");
+	};
+
+	const std::string title = "Startup timeline in ms (manager create: " + std::to_string(to_ms(prober->manager_create)) + " ms)";
+	std::fprintf(stdout, "| %-71s |\n", title.c_str());
+	print_table_separator_line();
+	std::fprintf(stdout, "| %-12s | %-12s | %-12s | %-12s | %-11s |\n", "CID", "CONNECT", "IDENTIFY", "SESSION", "FIRST FRAME");
+	print_table_separator_line();
+
+	std::sort(prober->timelines.begin(), prober->timelines.end(), [](const std::unique_ptr<seekprober_t::timeline_t>& lhs, const std::unique_ptr<seekprober_t::timeline_t>& rhs) {
+		return std::string(lhs->cid) < std::string(rhs->cid);
+	});
+
+	for(auto& timeline : prober->timelines)
+	{
+		const std::string session = timeline->session_status == SEEKCAMERA_SUCCESS ? std::to_string(to_ms(timeline->session_start)) : std::string("FAILED");
+		const std::string first_frame = timeline->has_first_frame.load() ? std::to_string(to_ms(timeline->first_frame)) : std::string("N/A");
+		std::fprintf(stdout, "| %-12s | %-12lld | %-12lld | %-12s | %-11s |\n",
+			timeline->cid,
+			to_ms(timeline->connect),
+			to_ms(timeline->identify),
+			session.c_str(),
+			first_frame.c_str());
+		print_table_separator_line();
+	}
+}
+
 // Signal handler function.
 static void signal_callback(int signum)
 {
@@ -241,6 +367,8 @@ void print_usage()
 		<< "\t   : Required - No\n"
 		<< "\t-d : Probe duration in seconds. Valid options: > 0 (default: 1)\n"
 		<< "\t   : Required - No\n"
+		<< "\t-t : Measures the startup timeline of each camera up to its first frame\n"
+		<< "\t   : Required - No\n"
 		<< "\t-h : Displays this message\n"
 		<< "\t   : Required - No"
 		<< std::endl;
@@ -252,8 +380,14 @@ void handle_camera_connect(seekcamera_t* camera, seekcamera_error_t event_status
 	(void)event_status;
 	(void)user_data;
 
+	const auto connect_time = seekprober_t::clock_t::now();
 	auto* prober = (seekprober_t*)user_data;
 	seekprober_add_metric(prober, camera);
+
+	if(prober->is_timeline_enabled)
+	{
+		seekprober_add_timeline(prober, camera, connect_time);
+	}
 }
 
 // Callback function for the camera manager; it fires whenever a camera event occurs.
@@ -284,6 +418,7 @@ int main(int argc, char** argv)
 	std::string discovery_mode_str("usb");
 	uint32_t discovery_mode = static_cast<uint32_t>(SEEKCAMERA_IO_TYPE_USB);
 	int duration_sec = 1;
+	bool is_timeline_enabled = false;
 
 	// Parse command line arguments.
 	for(int i = 1; i < argc; ++i)
@@ -339,6 +474,9 @@ int main(int argc, char** argv)
 						return 1;
 					}
 					break;
+				case 't':
+					is_timeline_enabled = true;
+					break;
 				case 'h':
 					print_usage();
 					return 0;
@@ -353,21 +491,25 @@ int main(int argc, char** argv)
 		<< "seekcamera-probe starting\n"
 		<< "settings:\n"
 		<< "\t1) mode (-m):          " << discovery_mode_str << '\n'
-		<< "\t2) duration (-d):      " << duration_sec << std::endl;
+		<< "\t2) duration (-d):      " << duration_sec << '\n'
+		<< "\t3) timeline (-t):      " << (is_timeline_enabled ? "on" : "off") << std::endl;
+
+	// Create the prober.
+	seekprober_t prober;
+	prober.is_timeline_enabled = is_timeline_enabled;
+	prober.start = seekprober_t::clock_t::now();
 
 	// Create the camera manager.
 	// This is the structure that owns all Seek camera devices.
 	seekcamera_manager_t* manager = nullptr;
 	seekcamera_error_t status = seekcamera_manager_create(&manager, discovery_mode);
+	prober.manager_create = seekprober_t::clock_t::now() - prober.start;
 	if(status != SEEKCAMERA_SUCCESS)
 	{
 		std::cerr << "failed to create camera manager: " << seekcamera_error_get_str(status) << std::endl;
 		return 1;
 	}
 
-	// Create the prober.
-	seekprober_t prober;
-
 	// Register an event handler for the camera manager to be called whenever a camera event occurs.
 	status = seekcamera_manager_register_event_callback(manager, camera_event_callback, (void*)&prober);
 	if(status != SEEKCAMERA_SUCCESS)
@@ -379,11 +521,18 @@ int main(int argc, char** argv)
 	// Wait for cameras to be probed.
 	std::this_thread::sleep_for(std::chrono::seconds(duration_sec));
 
+	// Capture sessions must have finished starting before the cameras are torn down.
+	seekprober_join_sessions(&prober);
+
 	// Teardown the camera manager.
 	seekcamera_manager_destroy(&manager);
 
 	// Print the metrics to the console.
 	seekprober_print_metrics(&prober);
+	if(prober.is_timeline_enabled)
+	{
+		seekprober_print_timelines(&prober);
+	}
 
 	return 0;
 }
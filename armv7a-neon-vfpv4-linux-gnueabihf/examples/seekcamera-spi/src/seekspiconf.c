@@ -0,0 +1,288 @@
+/*Copyright (c) [2020] [Seek Thermal, Inc.]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The Software may only be used in combination with Seek cores/products.
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:	 Seek Thermal SDK Demo
+ * Purpose:	 SPI configuration used to generate seekspi.conf programmatically
+ * Author:	 Seek Thermal, Inc.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <limits.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "seekspiconf.h"
+
+// Maximum value of the bus, cs and settling_time_ms settings.
+#define SEEKSPICONF_MAX_BYTE_VALUE 255u
+
+// Maximum GPIO number.
+#define SEEKSPICONF_MAX_GPIO 65536u
+
+// Checks a control node.
+static int seekspiconf_validate_ctrl(const seekspiconf_ctrl_t* ctrl, bool is_frame_sync)
+{
+	switch(ctrl->type)
+	{
+		case SEEKSPICONF_CTRL_TYPE_NONE:
+			return 0;
+		case SEEKSPICONF_CTRL_TYPE_GPIO:
+			if(ctrl->gpio > SEEKSPICONF_MAX_GPIO)
+			{
+				return -EINVAL;
+			}
+			break;
+		case SEEKSPICONF_CTRL_TYPE_IOCTL:
+			// FPA nSS can only be monitored through a GPIO.
+			if(is_frame_sync || ctrl->ioctl_bytes == 0)
+			{
+				return -EINVAL;
+			}
+			break;
+		default:
+			return -EINVAL;
+	}
+
+	return ctrl->settling_time_ms <= SEEKSPICONF_MAX_BYTE_VALUE ? 0 : -EINVAL;
+}
+
+// Writes a control node.
+static void seekspiconf_write_ctrl(FILE* file, const char* name, const seekspiconf_ctrl_t* ctrl, bool is_frame_sync)
+{
+	if(ctrl->type == SEEKSPICONF_CTRL_TYPE_NONE)
+	{
+		return;
+	}
+
+	fprintf(file, "    %s:\n", name);
+	if(ctrl->type == SEEKSPICONF_CTRL_TYPE_GPIO)
+	{
+		fprintf(file, "      gpio: %u\n", ctrl->gpio);
+	}
+	else
+	{
+		fprintf(file, "      ioctl:\n");
+		fprintf(file, "        request: %u\n", ctrl->ioctl_request);
+		fprintf(file, "        bytes: %u\n", ctrl->ioctl_bytes);
+	}
+
+	// The settling time is ignored for frame_sync nodes.
+	if(!is_frame_sync)
+	{
+		fprintf(file, "      settling_time_ms: %u\n", ctrl->settling_time_ms);
+	}
+	fprintf(file, "      inverting: %s\n", ctrl->inverting ? "true" : "false");
+}
+
+void seekspiconf_init(seekspiconf_t* config)
+{
+	memset(config, 0, sizeof(seekspiconf_t));
+	config->max_transfer_size = SEEKSPICONF_DEFAULT_MAX_TRANSFER_SIZE;
+	config->camera_sync = false;
+	config->bus_num = 0;
+	config->speed_hz = SEEKSPICONF_DEFAULT_SPEED_HZ;
+	config->num_cameras = 1;
+	config->cameras[0].cs = 0;
+}
+
+int seekspiconf_validate(const seekspiconf_t* config)
+{
+	if(config->max_transfer_size == 0 ||
+		config->bus_num > SEEKSPICONF_MAX_BYTE_VALUE ||
+		config->speed_hz == 0 ||
+		config->speed_hz > SEEKSPICONF_MAX_SPEED_HZ ||
+		config->num_cameras == 0 ||
+		config->num_cameras > SEEKSPICONF_MAX_CAMERAS)
+	{
+		return -EINVAL;
+	}
+
+	for(size_t i = 0; i < config->num_cameras; ++i)
+	{
+		const seekspiconf_camera_t* camera = &(config->cameras[i]);
+		if(camera->cs > SEEKSPICONF_MAX_BYTE_VALUE ||
+			seekspiconf_validate_ctrl(&(camera->frame_sync), true) != 0 ||
+			seekspiconf_validate_ctrl(&(camera->reset_ctrl), false) != 0 ||
+			seekspiconf_validate_ctrl(&(camera->power_ctrl), false) != 0)
+		{
+			return -EINVAL;
+		}
+
+		// Each camera needs a chip select of its own.
+		for(size_t j = 0; j < i; ++j)
+		{
+			if(config->cameras[j].cs == camera->cs)
+			{
+				return -EINVAL;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int seekspiconf_get_spidev_bufsiz(uint32_t* bufsiz)
+{
+	FILE* file = fopen("/sys/module/spidev/parameters/bufsiz", "r");
+	if(file == NULL)
+	{
+		return -errno;
+	}
+
+	unsigned int value = 0;
+	const int num_fields = fscanf(file, "%u", &value);
+	fclose(file);
+	if(num_fields != 1)
+	{
+		return -EIO;
+	}
+
+	*bufsiz = (uint32_t)value;
+	return 0;
+}
+
+int seekspiconf_get_default_path(char* path, size_t path_size)
+{
+	const char* home = getenv("HOME");
+	if(home == NULL || home[0] == '\0')
+	{
+		const struct passwd* pw = getpwuid(getuid());
+		home = pw != NULL ? pw->pw_dir : NULL;
+	}
+
+	if(home == NULL)
+	{
+		return -ENOENT;
+	}
+
+	if((size_t)snprintf(path, path_size, "%s/.seekthermal", home) >= path_size)
+	{
+		return -ENAMETOOLONG;
+	}
+
+	if(mkdir(path, 0755) != 0 && errno != EEXIST)
+	{
+		return -errno;
+	}
+
+	if((size_t)snprintf(path, path_size, "%s/.seekthermal/seekspi.conf", home) >= path_size)
+	{
+		return -ENAMETOOLONG;
+	}
+
+	return 0;
+}
+
+int seekspiconf_write(const seekspiconf_t* config, const char* path, bool keep_backup)
+{
+	int result = seekspiconf_validate(config);
+	if(result != 0)
+	{
+		return result;
+	}
+
+	char tmp_path[PATH_MAX];
+	char bak_path[PATH_MAX];
+	if((size_t)snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= sizeof(tmp_path) ||
+		(size_t)snprintf(bak_path, sizeof(bak_path), "%s.bak", path) >= sizeof(bak_path))
+	{
+		return -ENAMETOOLONG;
+	}
+
+	FILE* file = fopen(tmp_path, "w");
+	if(file == NULL)
+	{
+		return -errno;
+	}
+
+	// The layout follows the examples in the seekspi.conf reference; each camera is a repeated camera node.
+	fprintf(file, "# Generated by seekcamera-spi\n");
+	fprintf(file, "---\n");
+	fprintf(file, "driver: spidev\n");
+	fprintf(file, "max_transfer_size: %u\n", config->max_transfer_size);
+	fprintf(file, "camera_sync: %s\n", config->camera_sync ? "on" : "off");
+	fprintf(file, "bus:\n");
+	fprintf(file, "  num: %u\n", config->bus_num);
+	fprintf(file, "  speed_hz: %u\n", config->speed_hz);
+	for(size_t i = 0; i < config->num_cameras; ++i)
+	{
+		const seekspiconf_camera_t* camera = &(config->cameras[i]);
+		fprintf(file, "  camera:\n");
+		fprintf(file, "    cs: %u\n", camera->cs);
+		seekspiconf_write_ctrl(file, "reset_ctrl", &(camera->reset_ctrl), false);
+		seekspiconf_write_ctrl(file, "power_ctrl", &(camera->power_ctrl), false);
+		seekspiconf_write_ctrl(file, "frame_sync", &(camera->frame_sync), true);
+	}
+	fprintf(file, "...\n");
+
+	if(fflush(file) != 0 || fsync(fileno(file)) != 0)
+	{
+		result = -errno;
+	}
+
+	if(fclose(file) != 0 && result == 0)
+	{
+		result = -errno;
+	}
+
+	if(result != 0)
+	{
+		unlink(tmp_path);
+		return result;
+	}
+
+	// Keep the previous configuration; a hard link leaves the original in place until the rename replaces it.
+	if(keep_backup)
+	{
+		unlink(bak_path);
+		if(link(path, bak_path) != 0 && errno != ENOENT)
+		{
+			result = -errno;
+			unlink(tmp_path);
+			return result;
+		}
+	}
+
+	if(rename(tmp_path, path) != 0)
+	{
+		result = -errno;
+		unlink(tmp_path);
+		return result;
+	}
+
+	return 0;
+}
@@ -33,7 +33,9 @@ SOFTWARE.
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #ifdef _WIN32
 #	include <windows.h>
@@ -41,6 +43,7 @@ SOFTWARE.
 #endif
 
 #if defined(__linux__) || defined(__APPLE__)
+#	include <pthread.h>
 #	include <unistd.h>
 #	include <sys/time.h>
 #endif
@@ -49,21 +52,76 @@ SOFTWARE.
 #include "seekcamera/seekcamera_manager.h"
 
 // Options
-#define NUM_MAX_DEVICES     15
+#define NUM_MAX_DEVICES     64
 #define MAX_FILENAME_LENGTH 64
+#define NUM_MAX_FILTERS     16
+#define MAX_FILTER_LENGTH   32
+
+// Watchdog options
+#define DEFAULT_MAX_RESTARTS     3
+#define WATCHDOG_POLL_PERIOD_MS  100
+
+// Structure holding the identity and IO properties of a Seek camera.
+// It is read once on connect and served from memory afterwards so that callbacks never query the camera.
+typedef struct sampleinfo_t
+{
+	seekcamera_chipid_t cid;
+	seekcamera_serial_number_t sn;
+	seekcamera_core_part_number_t cpn;
+	seekcamera_firmware_version_t fw;
+	seekcamera_io_properties_t io;
+} sampleinfo_t;
+
+// Enumerated type representing which camera property a discovery filter matches.
+typedef enum samplefilter_type_t
+{
+	SAMPLE_FILTER_TYPE_CID,
+	SAMPLE_FILTER_TYPE_SN,
+	SAMPLE_FILTER_TYPE_USB,
+	SAMPLE_FILTER_TYPE_SPI,
+} samplefilter_type_t;
+
+// Structure holding a single discovery filter.
+typedef struct samplefilter_t
+{
+	samplefilter_type_t type;
+	char value[MAX_FILTER_LENGTH];
+} samplefilter_t;
+
+// Mutex type used to guard a camera context.
+#ifdef _WIN32
+typedef CRITICAL_SECTION samplemutex_t;
+#else
+typedef pthread_mutex_t samplemutex_t;
+#endif
 
 // Structure holding the context for a Seek camera and additional application level metadata.
+// The context is shared by the camera manager event thread, the frame callback and the watchdog on the main thread;
+// every field is guarded by the mutex.
 typedef struct samplectx_t
 {
+	samplemutex_t mutex;
 	bool is_free;
 	bool is_live;
 	FILE* log;
 	seekcamera_t* camera;
+	sampleinfo_t info;
+
+	// Watchdog state.
+	uint64_t last_frame_ms;
+	uint64_t stall_start_ms;
+	uint64_t last_restart_ms;
+	int num_restarts;
+	int num_recoveries;
 } samplectx_t;
 
 // Define the global variables.
 volatile bool g_keep_running = true;
 static samplectx_t g_ctx_pool[NUM_MAX_DEVICES] = { 0 };
+static samplefilter_t g_filters[NUM_MAX_FILTERS] = { 0 };
+static int g_num_filters = 0;
+static int g_watchdog_timeout_ms = 0;
+static int g_max_restarts = DEFAULT_MAX_RESTARTS;
 
 // Signal handler function.
 static void signal_callback(int signum)
@@ -74,22 +132,279 @@ static void signal_callback(int signum)
 	g_keep_running = false;
 }
 
+// Initializes a context mutex.
+void sample_mutex_init(samplemutex_t* mutex)
+{
+#ifdef _WIN32
+	InitializeCriticalSection(mutex);
+#else
+	pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+// Destroys a context mutex.
+void sample_mutex_destroy(samplemutex_t* mutex)
+{
+#ifdef _WIN32
+	DeleteCriticalSection(mutex);
+#else
+	pthread_mutex_destroy(mutex);
+#endif
+}
+
+// Locks a context mutex.
+void sample_mutex_lock(samplemutex_t* mutex)
+{
+#ifdef _WIN32
+	EnterCriticalSection(mutex);
+#else
+	pthread_mutex_lock(mutex);
+#endif
+}
+
+// Tries to lock a context mutex without blocking.
+// Returns true if the mutex was locked.
+bool sample_mutex_trylock(samplemutex_t* mutex)
+{
+#ifdef _WIN32
+	return TryEnterCriticalSection(mutex) != 0;
+#else
+	return pthread_mutex_trylock(mutex) == 0;
+#endif
+}
+
+// Unlocks a context mutex.
+void sample_mutex_unlock(samplemutex_t* mutex)
+{
+#ifdef _WIN32
+	LeaveCriticalSection(mutex);
+#else
+	pthread_mutex_unlock(mutex);
+#endif
+}
+
 // Prints the usage instructions.
 void print_usage()
 {
 	fprintf(stdout, "Allowed options\n");
 	fprintf(stdout, "\t-m : Discovery mode. Valid options: usb, spi, all (default: usb)\n");
 	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-f : Discovery filter; may be repeated. Valid options: cid=CID, sn=SN, usb=BUS-PORT[.PORT...], spi=BUS.CS\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-w : Watchdog timeout in ms; a camera without frames for longer is restarted. Valid options: >= 0 (default: 0, off)\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-r : Watchdog restarts per stall before giving up on a camera. Valid options: >= 1 (default: %d)\n", DEFAULT_MAX_RESTARTS);
+	fprintf(stdout, "\t   : Required - No\n");
 	fprintf(stdout, "\t-h : Displays this message\n");
 	fprintf(stdout, "\t   : Required - No\n");
 }
 
-// Callback function for a particular Seek camera.
-// This function fires whenever a frame is available.
-void frame_available_callback(seekcamera_t* camera, seekcamera_frame_t* camera_frame, void* user_data)
+// Gets a monotonic time in milliseconds.
+uint64_t get_time_ms()
 {
-	samplectx_t* ctx = (samplectx_t*)user_data;
+#ifdef _WIN32
+	return (uint64_t)GetTickCount64();
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+#endif
+}
+
+// Reads the identity and IO properties of a camera in one pass.
+seekcamera_error_t get_camera_info(seekcamera_t* camera, sampleinfo_t* info)
+{
+	memset(info, 0, sizeof(sampleinfo_t));
+
+	seekcamera_error_t status = seekcamera_get_chipid(camera, &(info->cid));
+	if(status == SEEKCAMERA_SUCCESS)
+	{
+		status = seekcamera_get_serial_number(camera, &(info->sn));
+	}
+
+	if(status == SEEKCAMERA_SUCCESS)
+	{
+		status = seekcamera_get_core_part_number(camera, &(info->cpn));
+	}
+
+	if(status == SEEKCAMERA_SUCCESS)
+	{
+		status = seekcamera_get_firmware_version(camera, &(info->fw));
+	}
+
+	if(status == SEEKCAMERA_SUCCESS)
+	{
+		status = seekcamera_get_io_properties(camera, &(info->io));
+	}
+
+	return status;
+}
+
+// Parses a discovery filter of the form type=value.
+// Returns true on success.
+bool parse_filter(const char* arg, samplefilter_t* filter)
+{
+	const char* value = strchr(arg, '=');
+	if(value == NULL || strlen(value + 1) == 0 || strlen(value + 1) >= MAX_FILTER_LENGTH)
+	{
+		return false;
+	}
+
+	const size_t type_length = (size_t)(value - arg);
+	if(type_length == 3 && strncmp(arg, "cid", 3) == 0)
+	{
+		filter->type = SAMPLE_FILTER_TYPE_CID;
+	}
+	else if(type_length == 2 && strncmp(arg, "sn", 2) == 0)
+	{
+		filter->type = SAMPLE_FILTER_TYPE_SN;
+	}
+	else if(type_length == 3 && strncmp(arg, "usb", 3) == 0)
+	{
+		filter->type = SAMPLE_FILTER_TYPE_USB;
+	}
+	else if(type_length == 3 && strncmp(arg, "spi", 3) == 0)
+	{
+		filter->type = SAMPLE_FILTER_TYPE_SPI;
+	}
+	else
+	{
+		return false;
+	}
 
+	snprintf(filter->value, MAX_FILTER_LENGTH, "%s", value + 1);
+	return true;
+}
+
+// Formats the IO location of a camera the way it is written in a discovery filter.
+// USB cameras use the kernel device name (e.g. 1-1.2) and SPI cameras use the spidev name (e.g. 0.1).
+void format_io_location(const seekcamera_io_properties_t* io, char* location, size_t size)
+{
+	location[0] = '\0';
+	if(io->type == SEEKCAMERA_IO_TYPE_USB)
+	{
+		size_t length = (size_t)snprintf(location, size, "%u", io->properties.usb.bus_number);
+		char separator = '-';
+		for(size_t i = 0; i < sizeof(io->properties.usb.port_numbers) && length < size; ++i)
+		{
+			// Zero (0) is reserved for invalid ports; any non-zero ports are valid.
+			const uint8_t port_number = io->properties.usb.port_numbers[i];
+			if(port_number == 0)
+			{
+				break;
+			}
+			length += (size_t)snprintf(location + length, size - length, "%c%u", separator, port_number);
+			separator = '.';
+		}
+	}
+	else if(io->type == SEEKCAMERA_IO_TYPE_SPI)
+	{
+		snprintf(location, size, "%u.%u", io->properties.spi.bus_number, io->properties.spi.cs_number);
+	}
+}
+
+// Checks a camera against the discovery filters.
+// A camera is allowed when no filters are set or when it matches any one of them.
+bool is_camera_allowed(const sampleinfo_t* info)
+{
+	if(g_num_filters == 0)
+	{
+		return true;
+	}
+
+	char location[MAX_FILTER_LENGTH] = { 0 };
+	format_io_location(&(info->io), location, sizeof(location));
+
+	for(int i = 0; i < g_num_filters; ++i)
+	{
+		const samplefilter_t* filter = &(g_filters[i]);
+		switch(filter->type)
+		{
+			case SAMPLE_FILTER_TYPE_CID:
+				if(strcmp(filter->value, info->cid) == 0)
+				{
+					return true;
+				}
+				break;
+			case SAMPLE_FILTER_TYPE_SN:
+				if(strcmp(filter->value, info->sn) == 0)
+				{
+					return true;
+				}
+				break;
+			case SAMPLE_FILTER_TYPE_USB:
+				if(info->io.type == SEEKCAMERA_IO_TYPE_USB && strcmp(filter->value, location) == 0)
+				{
+					return true;
+				}
+				break;
+			case SAMPLE_FILTER_TYPE_SPI:
+				if(info->io.type == SEEKCAMERA_IO_TYPE_SPI && strcmp(filter->value, location) == 0)
+				{
+					return true;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	return false;
+}
+
+// Finds the context associated with a camera.
+// Returns NULL if the camera is not associated with any context.
+samplectx_t* find_ctx(const seekcamera_t* camera)
+{
+	for(int i = 0; i < NUM_MAX_DEVICES; ++i)
+	{
+		if(!g_ctx_pool[i].is_free && g_ctx_pool[i].camera == camera)
+		{
+			return &(g_ctx_pool[i]);
+		}
+	}
+
+	return NULL;
+}
+
+// Gets the chip ID of a camera.
+// Cameras that are already tracked are served from their cached info; only newly connected cameras are queried.
+void get_cached_chipid(seekcamera_t* camera, seekcamera_chipid_t* cid)
+{
+	const samplectx_t* ctx = find_ctx(camera);
+	if(ctx != NULL)
+	{
+		memcpy(*cid, ctx->info.cid, sizeof(seekcamera_chipid_t));
+	}
+	else
+	{
+		seekcamera_get_chipid(camera, cid);
+	}
+}
+
+// Records that a camera delivered a frame, whether or not the frame can be logged.
+// Frames arriving after the watchdog restarted the camera mean that it has recovered.
+// The context mutex must be held.
+void record_frame(samplectx_t* ctx)
+{
+	const uint64_t now_ms = get_time_ms();
+	ctx->last_frame_ms = now_ms;
+	if(ctx->stall_start_ms != 0)
+	{
+		++ctx->num_recoveries;
+		fprintf(stdout, "watchdog: %s recovered after %d restart(s) in %llu ms\n",
+			ctx->info.cid,
+			ctx->num_restarts,
+			(unsigned long long)(now_ms - ctx->stall_start_ms));
+		ctx->stall_start_ms = 0;
+		ctx->num_restarts = 0;
+	}
+}
+
+// Logs a frame to the CSV file of its camera.
+// The context mutex must be held.
+void log_frame(samplectx_t* ctx, seekcamera_frame_t* camera_frame)
+{
 	if(!ctx->is_live)
 	{
 		fprintf(stderr, "unable to continue: camera is not live\n");
@@ -102,8 +417,7 @@ void frame_available_callback(seekcamera_t* camera, seekcamera_frame_t* camera_f
 		return;
 	}
 
-	seekcamera_chipid_t cid;
-	seekcamera_get_chipid(camera, &cid);
+	const char* cid = ctx->info.cid;
 
 	seekframe_t* frame = NULL;
 	const seekcamera_error_t status = seekcamera_frame_get_frame_by_format(
@@ -268,12 +582,63 @@ void frame_available_callback(seekcamera_t* camera, seekcamera_frame_t* camera_f
 	}
 }
 
+// Callback function for a particular Seek camera.
+// This function fires whenever a frame is available.
+void frame_available_callback(seekcamera_t* camera, seekcamera_frame_t* camera_frame, void* user_data)
+{
+	(void)camera;
+	samplectx_t* ctx = (samplectx_t*)user_data;
+
+	// The context is only held elsewhere while its capture session is being started, restarted or stopped.
+	// Waiting for it here could deadlock with stopping the session, so the frame is dropped instead.
+	// Frames dropped this way do not count toward liveness.
+	if(!sample_mutex_trylock(&(ctx->mutex)))
+	{
+		return;
+	}
+
+	if(!ctx->is_free && ctx->camera == camera)
+	{
+		record_frame(ctx);
+		log_frame(ctx, camera_frame);
+	}
+
+	sample_mutex_unlock(&(ctx->mutex));
+}
+
 // Handles camera connect events.
 void handle_camera_connect(seekcamera_t* camera, seekcamera_error_t event_status, void* user_data)
 {
 	(void)event_status;
 	(void)user_data;
 
+	// Snapshot the camera identity so that it is never queried again while the camera is connected.
+	sampleinfo_t info;
+	seekcamera_error_t status = get_camera_info(camera, &info);
+	if(status == SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stdout, "camera info: %s (SN: %s, CPN: %s, FW: %u.%u.%u.%u)\n",
+			info.cid,
+			info.sn,
+			info.cpn,
+			info.fw.product,
+			info.fw.variant,
+			info.fw.major,
+			info.fw.minor);
+	}
+	else
+	{
+		fprintf(stderr, "failed to get camera info: %s (%s)\n", info.cid, seekcamera_error_get_str(status));
+	}
+
+	// Cameras that do not pass the discovery filters are left idle.
+	// They are never assigned a context, so no capture session is started and no log file is created for them.
+	if(!is_camera_allowed(&info))
+	{
+		fprintf(stdout, "camera filtered out: %s\n", info.cid);
+		return;
+	}
+
 	// Each camera is associated with an application level context structure.
 	// On each connect, the available context resource pool is searched to find a free context.
 	samplectx_t* ctx = NULL;
@@ -294,20 +659,28 @@ void handle_camera_connect(seekcamera_t* camera, seekcamera_error_t event_status
 		return;
 	}
 
-	seekcamera_chipid_t cid;
-	seekcamera_get_chipid(camera, &cid);
+	// Enter critical section.
+	// The context is only claimed and released by the camera manager event thread, so the search above needs no lock.
+	sample_mutex_lock(&(ctx->mutex));
 
 	// Reset the context values to be assocated with this camera.
 	ctx->is_free = false;
 	ctx->is_live = false;
 	ctx->log = NULL;
 	ctx->camera = camera;
+	ctx->info = info;
+	ctx->last_frame_ms = get_time_ms();
+	ctx->stall_start_ms = 0;
+	ctx->last_restart_ms = 0;
+	ctx->num_restarts = 0;
+	ctx->num_recoveries = 0;
+	const char* cid = ctx->info.cid;
 
 	// The Seek camera API is asynchronous and event driven.
 	// Frames are delivered to a unique callback function which is registered on a per camera basis.
 	// Each callback passes an optional piece of user data.
 	// The sample application passes the associated context structure as this optional piece of user data.
-	seekcamera_error_t status = seekcamera_register_frame_available_callback(
+	status = seekcamera_register_frame_available_callback(
 		camera,
 		frame_available_callback,
 		(void*)ctx);
@@ -354,6 +727,8 @@ void handle_camera_connect(seekcamera_t* camera, seekcamera_error_t event_status
 	{
 		fprintf(stderr, "failed to open log file: %s\n", cid);
 	}
+
+	sample_mutex_unlock(&(ctx->mutex));
 }
 
 // Handles camera disconnect events.
@@ -363,34 +738,19 @@ void handle_camera_disconnect(seekcamera_t* camera, seekcamera_error_t event_sta
 	(void)user_data;
 
 	// Search for the resource pool for the context associated with the camera.
-	// The context and camera can be uniquely associated using chip id.
-	samplectx_t* ctx = NULL;
-	for(int i = 0; i < NUM_MAX_DEVICES && (ctx == NULL); ++i)
-	{
-		samplectx_t* candidate_ctx = &(g_ctx_pool[i]);
-		if(candidate_ctx->camera != NULL)
-		{
-			seekcamera_chipid_t cid;
-			seekcamera_get_chipid(camera, &cid);
-
-			seekcamera_chipid_t candidate_cid;
-			seekcamera_get_chipid(candidate_ctx->camera, &candidate_cid);
-
-			if(strcmp(cid, candidate_cid) == 0)
-			{
-				ctx = candidate_ctx;
-			}
-		}
-	}
+	// The camera handle stays the same for as long as the camera is connected.
+	samplectx_t* ctx = find_ctx(camera);
 
 	// The camera is not associated with any context.
-	// This should never happen but is accounted for nonetheless.
+	// This is expected for cameras that were filtered out or that connected while the context pool was exhausted.
 	if(ctx == NULL)
 	{
-		fprintf(stderr, "failed to find associated context\n");
 		return;
 	}
 
+	// Enter critical section.
+	sample_mutex_lock(&(ctx->mutex));
+
 	// Stop the capture session.
 	// Care should be taken to synchronize any state depending on the camera.
 	if(ctx->is_live)
@@ -405,10 +765,18 @@ void handle_camera_disconnect(seekcamera_t* camera, seekcamera_error_t event_sta
 		ctx->log = NULL;
 	}
 
+	if(ctx->num_recoveries > 0)
+	{
+		fprintf(stdout, "watchdog: %s recovered from %d stall(s) while connected\n", ctx->info.cid, ctx->num_recoveries);
+	}
+
 	// Invalidate the tracked metadata.
 	ctx->is_free = true;
 	ctx->is_live = false;
 	ctx->camera = NULL;
+	memset(&(ctx->info), 0, sizeof(sampleinfo_t));
+
+	sample_mutex_unlock(&(ctx->mutex));
 }
 
 // Handles camera error events.
@@ -417,16 +785,77 @@ void handle_camera_error(seekcamera_t* camera, seekcamera_error_t event_status,
 	(void)user_data;
 
 	seekcamera_chipid_t cid;
-	seekcamera_get_chipid(camera, &cid);
+	get_cached_chipid(camera, &cid);
 	fprintf(stderr, "encountered unexpected error: %s (%s)", cid, seekcamera_error_get_str(event_status));
 }
 
+// Restarts the capture session of a camera that stopped delivering frames without disconnecting.
+// Each stall is retried up to the maximum number of restarts, waiting one timeout between restarts.
+// Cameras that do not recover are left stopped until they disconnect.
+// The context mutex must be held.
+void check_ctx_watchdog(samplectx_t* ctx, uint64_t now_ms)
+{
+	const uint64_t last_frame_ms = ctx->last_frame_ms;
+	const uint64_t timeout_ms = (uint64_t)g_watchdog_timeout_ms;
+	if(now_ms < last_frame_ms + timeout_ms || (ctx->num_restarts > 0 && now_ms < ctx->last_restart_ms + timeout_ms))
+	{
+		return;
+	}
+
+	const char* cid = ctx->info.cid;
+	if(ctx->stall_start_ms == 0)
+	{
+		ctx->stall_start_ms = last_frame_ms;
+	}
+
+	if(ctx->num_restarts >= g_max_restarts)
+	{
+		fprintf(stderr, "watchdog: %s did not recover after %d restart(s); stopping capture session\n", cid, ctx->num_restarts);
+		seekcamera_capture_session_stop(ctx->camera);
+		ctx->is_live = false;
+		return;
+	}
+
+	++ctx->num_restarts;
+	ctx->last_restart_ms = now_ms;
+	fprintf(stderr, "watchdog: %s stalled for %llu ms; restarting capture session (%d/%d)\n",
+		cid,
+		(unsigned long long)(now_ms - ctx->stall_start_ms),
+		ctx->num_restarts,
+		g_max_restarts);
+
+	seekcamera_capture_session_stop(ctx->camera);
+	const seekcamera_error_t status = seekcamera_capture_session_start(ctx->camera, SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stderr, "failed to restart capture session: %s (%s)\n", cid, seekcamera_error_get_str(status));
+	}
+}
+
+// Checks every live camera for stalls.
+void check_watchdog()
+{
+	const uint64_t now_ms = get_time_ms();
+	for(int i = 0; i < NUM_MAX_DEVICES; ++i)
+	{
+		// Enter critical section.
+		// The camera may have disconnected, or its context been given to another camera, since the last check.
+		samplectx_t* ctx = &(g_ctx_pool[i]);
+		sample_mutex_lock(&(ctx->mutex));
+		if(!ctx->is_free && ctx->camera != NULL && ctx->is_live)
+		{
+			check_ctx_watchdog(ctx, now_ms);
+		}
+		sample_mutex_unlock(&(ctx->mutex));
+	}
+}
+
 // Callback function for the Seek camera manager.
 // This function fires whenever a camera event occurs for a given camera manager context.
 void camera_event_callback(seekcamera_t* camera, seekcamera_manager_event_t event, seekcamera_error_t event_status, void* user_data)
 {
 	seekcamera_chipid_t cid;
-	seekcamera_get_chipid(camera, &cid);
+	get_cached_chipid(camera, &cid);
 
 	fprintf(stdout, "%s: %s\n", seekcamera_manager_get_event_str(event), cid);
 
@@ -495,6 +924,33 @@ int main(int argc, char** argv)
 						return 1;
 					}
 					break;
+				case 'f':
+					if(i < argc - 1 && g_num_filters < NUM_MAX_FILTERS && parse_filter(argv[i + 1], &(g_filters[g_num_filters])))
+					{
+						++g_num_filters;
+					}
+					else
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'w':
+					g_watchdog_timeout_ms = i < argc - 1 ? atoi(argv[i + 1]) : -1;
+					if(g_watchdog_timeout_ms < 0)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
+				case 'r':
+					g_max_restarts = i < argc - 1 ? atoi(argv[i + 1]) : 0;
+					if(g_max_restarts < 1)
+					{
+						print_usage();
+						return 1;
+					}
+					break;
 				case 'h':
 					print_usage();
 					return 0;
@@ -507,12 +963,22 @@ int main(int argc, char** argv)
 	fprintf(stdout, "seekcamera-simple starting\n");
 	fprintf(stdout, "settings\n");
 	fprintf(stdout, "\t1) mode (-m): %s\n", discovery_mode_str);
+	for(int i = 0; i < g_num_filters; ++i)
+	{
+		static const char* filter_type_strs[] = { "cid", "sn", "usb", "spi" };
+		fprintf(stdout, "\t2) filter (-f): %s=%s\n", filter_type_strs[g_filters[i].type], g_filters[i].value);
+	}
+	if(g_watchdog_timeout_ms > 0)
+	{
+		fprintf(stdout, "\t3) watchdog (-w): %d ms, %d restart(s) (-r)\n", g_watchdog_timeout_ms, g_max_restarts);
+	}
 	fflush(stdout);
 
 	// Setup the global context pool.
 	// Each context tracks additional application-level meta data that is associated on a per-camera basis.
 	for(int i = 0; i < NUM_MAX_DEVICES; ++i)
 	{
+		sample_mutex_init(&(g_ctx_pool[i].mutex));
 		g_ctx_pool[i].is_free = true;
 		g_ctx_pool[i].is_live = false;
 		g_ctx_pool[i].log = NULL;
@@ -543,9 +1009,15 @@ int main(int argc, char** argv)
 	// Camera events are asynchronous and interrupt the current thread.
 	// There are much better ways of keeping the main thread alive.
 	// This is just a simple example.
+	// The watchdog runs from the main thread, so it polls often enough to recover a camera within its timeout.
 	while(g_keep_running)
 	{
-		const int sleep_ms = 1000;
+		const int sleep_ms = g_watchdog_timeout_ms > 0 ? WATCHDOG_POLL_PERIOD_MS : 1000;
+		if(g_watchdog_timeout_ms > 0)
+		{
+			check_watchdog();
+		}
+
 #ifdef _WIN32
 		Sleep(sleep_ms);
 #else
@@ -569,6 +1041,7 @@ int main(int argc, char** argv)
 		g_ctx_pool[i].is_live = false;
 		g_ctx_pool[i].log = NULL;
 		g_ctx_pool[i].camera = NULL;
+		sample_mutex_destroy(&(g_ctx_pool[i].mutex));
 	}
 
 	fprintf(stdout, "done\n");
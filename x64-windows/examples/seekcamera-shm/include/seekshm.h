@@ -0,0 +1,224 @@
+/*Copyright (c) [2020] [Seek Thermal, Inc.]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The Software may only be used in combination with Seek cores/products.
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:	 Seek Thermal SDK Demo
+ * Purpose:	 Shared memory frame ring used to publish frames to other processes
+ * Author:	 Seek Thermal, Inc.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SEEKSHM_H__
+#define __SEEKSHM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "seekcamera/seekcamera_frame.h"
+#include "seekframe/seekframe.h"
+
+//-----------------------------------------------------------------------------
+// Types
+//-----------------------------------------------------------------------------
+// Identifies a mapped region as a Seek frame ring.
+#define SEEKSHM_MAGIC 0x4B454553u
+
+// Version of the ring layout; bumped whenever the layout changes.
+#define SEEKSHM_VERSION 2u
+
+// Alignment of each slot within the ring in bytes.
+#define SEEKSHM_SLOT_ALIGNMENT 64u
+
+// Header at the start of the shared memory region.
+// Every field except is_closed, write_index and futex_word is immutable once the ring is created.
+typedef struct seekshm_ring_header_t
+{
+	uint32_t magic;          // SEEKSHM_MAGIC
+	uint32_t version;        // SEEKSHM_VERSION
+	uint32_t num_slots;      // Number of frame slots in the ring
+	uint32_t slot_stride;    // Number of bytes between the start of consecutive slots
+	uint32_t max_data_size;  // Maximum number of pixel data bytes per slot
+	uint32_t frame_format;   // Frame format published to the ring (seekcamera_frame_format_t)
+	uint32_t futex_word;     // Incremented after every publish; readers wait on it
+	uint32_t is_closed;      // Set once the publisher has destroyed the ring; readers must reopen it
+	uint64_t write_index;    // Number of frames published so far
+} seekshm_ring_header_t;
+
+// Suffix appended to the name of a named ring to form the name of its waiters region.
+#define SEEKSHM_WAITERS_SUFFIX ".waiters"
+
+// Header of the small region, separate from the ring, in which clients announce that they are blocked.
+// Clients map the ring read-only but the waiters region read-write; the publisher only wakes the futex while
+// num_waiters is non-zero.
+typedef struct seekshm_waiters_header_t
+{
+	uint32_t num_waiters; // Number of clients blocked on futex_word
+	uint32_t reserved;    // Reserved for alignment
+} seekshm_waiters_header_t;
+
+// Header at the start of each slot.
+// The sequence number is odd while the slot is being written and even once it is stable.
+typedef struct seekshm_slot_header_t
+{
+	uint64_t sequence;    // Per-slot sequence number
+	uint64_t frame_index; // Index of the frame held by the slot (zero based)
+	uint32_t data_size;   // Number of pixel data bytes held by the slot
+	uint8_t reserved[SEEKSHM_SLOT_ALIGNMENT - 20];
+} seekshm_slot_header_t;
+
+// Structure that owns the writable side of a ring.
+typedef struct seekshm_publisher_t seekshm_publisher_t;
+
+// Structure that owns the read-only side of a ring.
+typedef struct seekshm_client_t seekshm_client_t;
+
+// Read-only view of a single frame held by a ring slot.
+// The pointers alias shared memory; the view must be validated after it has been consumed.
+typedef struct seekshm_view_t
+{
+	const seekcamera_frame_header_t* header;
+	const void* data;
+	size_t data_size;
+	uint64_t frame_index;
+	uint64_t sequence;
+	const seekshm_slot_header_t* slot;
+} seekshm_view_t;
+
+//-----------------------------------------------------------------------------
+// Publisher functions
+//-----------------------------------------------------------------------------
+// Creates a named ring with a fixed number of slots, along with its waiters region.
+// Each slot holds a frame header and up to max_data_size bytes of pixel data.
+// Returns 0 on success or a negative errno value on failure.
+int seekshm_publisher_create(
+	seekshm_publisher_t** publisher,
+	const char* name,
+	uint32_t num_slots,
+	size_t max_data_size,
+	uint32_t frame_format);
+
+// Creates an anonymous ring backed by a sealed memfd instead of a named POSIX shared memory object.
+// The ring is only reachable through descriptors obtained with seekshm_publisher_get_fd and
+// seekshm_publisher_get_waiters_fd.
+// Returns 0 on success, -ENOSYS where memfd is unavailable or a negative errno value on failure.
+int seekshm_publisher_create_memfd(
+	seekshm_publisher_t** publisher,
+	const char* name,
+	uint32_t num_slots,
+	size_t max_data_size,
+	uint32_t frame_format);
+
+// Marks a ring as closed, wakes its clients, then unmaps and unlinks it and its waiters region.
+void seekshm_publisher_destroy(
+	seekshm_publisher_t** publisher);
+
+// Copies a frame into the next slot of the ring and wakes any waiting clients.
+// The futex is only woken while a client announces that it is waiting.
+// Returns 0 on success or a negative errno value on failure.
+int seekshm_publisher_write(
+	seekshm_publisher_t* publisher,
+	const seekframe_t* frame);
+
+// Gets a new read-only descriptor for a memfd backed ring.
+// The descriptor is owned by the caller and may be passed to another process with seekshm_send_fd.
+// Returns 0 on success, -ENOTSUP for named rings or a negative errno value on failure.
+int seekshm_publisher_get_fd(
+	const seekshm_publisher_t* publisher,
+	int* fd);
+
+// Gets a new read-write descriptor for the waiters region of a memfd backed ring.
+// The descriptor is owned by the caller and must be handed to the client along with the ring descriptor.
+// Returns 0 on success, -ENOTSUP for named rings or a negative errno value on failure.
+int seekshm_publisher_get_waiters_fd(
+	const seekshm_publisher_t* publisher,
+	int* fd);
+
+//-----------------------------------------------------------------------------
+// Client functions
+//-----------------------------------------------------------------------------
+// Maps an existing named ring read-only and its waiters region read-write.
+// Returns 0 on success or a negative errno value on failure.
+int seekshm_client_open(
+	seekshm_client_t** client,
+	const char* name);
+
+// Maps a ring read-only and its waiters region read-write from descriptors, e.g. ones received with seekshm_recv_fd.
+// The descriptors are not consumed and may be closed once this returns.
+// Returns 0 on success or a negative errno value on failure.
+int seekshm_client_open_fd(
+	seekshm_client_t** client,
+	int fd,
+	int waiters_fd);
+
+// Unmaps a ring and its waiters region.
+void seekshm_client_close(
+	seekshm_client_t** client);
+
+// Blocks until a frame newer than the last one acquired is published, the ring is closed or the timeout expires.
+// A negative timeout waits forever.
+// Returns 0 when a new frame is available, -ETIMEDOUT on timeout or -EPIPE once the publisher has closed the ring.
+int seekshm_client_wait(
+	seekshm_client_t* client,
+	int timeout_ms);
+
+// Acquires a view of the most recently published frame without copying it.
+// Returns 0 on success, -EAGAIN if no stable frame is available.
+int seekshm_client_acquire(
+	seekshm_client_t* client,
+	seekshm_view_t* view);
+
+// Checks that the slot backing a view was not overwritten while the view was in use.
+// Data read through a view must be discarded if this returns false.
+bool seekshm_client_validate(
+	const seekshm_client_t* client,
+	const seekshm_view_t* view);
+
+// Gets the number of frames that were overwritten before this client could acquire them.
+uint64_t seekshm_client_get_dropped(
+	const seekshm_client_t* client);
+
+//-----------------------------------------------------------------------------
+// Descriptor passing functions
+//-----------------------------------------------------------------------------
+// Sends a descriptor over a connected Unix domain socket using SCM_RIGHTS.
+// Returns 0 on success or a negative errno value on failure.
+int seekshm_send_fd(
+	int socket_fd,
+	int fd);
+
+// Receives a descriptor sent with seekshm_send_fd.
+// Returns 0 on success or a negative errno value on failure.
+int seekshm_recv_fd(
+	int socket_fd,
+	int* fd);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __SEEKSHM_H__ */
@@ -0,0 +1,729 @@
+/*Copyright (c) [2020] [Seek Thermal, Inc.]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The Software may only be used in combination with Seek cores/products.
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:	 Seek Thermal SDK Demo
+ * Purpose:	 Demonstrates how to configure and verify Seek Thermal SPI cameras programmatically
+ * Author:	 Seek Thermal, Inc.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/resource.h>
+
+#include "seekcamera/seekcamera.h"
+#include "seekcamera/seekcamera_manager.h"
+#include "seekspiconf.h"
+
+// Options
+#define NUM_MAX_DEVICES           SEEKSPICONF_MAX_CAMERAS
+#define DEFAULT_SETTLING_TIME_MS  40
+#define DEFAULT_DURATION_SEC      5
+#define NUM_MAX_SWEEP_VALUES      16
+
+// Trials whose frame rate is within this fraction of the best one are ranked by CPU time per frame instead.
+#define SWEEP_FPS_TOLERANCE       0.01
+
+// Structure holding the context for a Seek camera under test.
+typedef struct samplectx_t
+{
+	bool is_free;
+	seekcamera_t* camera;
+	seekcamera_chipid_t cid;
+	uint64_t num_frames;
+} samplectx_t;
+
+// Structure holding the result of streaming with one configuration.
+typedef struct sampletrial_t
+{
+	size_t num_cameras;
+	uint64_t num_frames;
+	uint64_t num_errors;
+	double elapsed_sec;
+	double cpu_sec;
+	bool is_complete;
+} sampletrial_t;
+
+// Define the global variables.
+volatile bool g_keep_running = true;
+static samplectx_t g_ctx_pool[NUM_MAX_DEVICES];
+static uint64_t g_num_errors = 0;
+
+// Signal handler function.
+static void signal_callback(int signum)
+{
+	(void)signum;
+
+	fprintf(stdout, "\nCaught Ctrl+C\n\n");
+	g_keep_running = false;
+}
+
+// Prints the usage instructions.
+void print_usage()
+{
+	fprintf(stdout, "Allowed options\n");
+	fprintf(stdout, "\t-b : SPI bus number, i.e. A in /dev/spidevA.B (default: 0)\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-c : Comma separated chip select numbers, i.e. B in /dev/spidevA.B (default: 0)\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-s : SCLK speed in Hz; a comma separated list sweeps every speed. Valid options: 1-%u (default: %u)\n", SEEKSPICONF_MAX_SPEED_HZ, SEEKSPICONF_DEFAULT_SPEED_HZ);
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-t : Max transfer size in bytes, or auto to use the spidev bufsiz; a comma separated list sweeps every size (default: %u)\n", SEEKSPICONF_DEFAULT_MAX_TRANSFER_SIZE);
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-y : Camera sync. Valid options: on, off (default: off)\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-r : Comma separated reset_ctrl GPIO numbers; one per camera\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-p : Comma separated power_ctrl GPIO numbers; one per camera\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-f : Comma separated frame_sync GPIO numbers; one per camera\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-w : Settling time of reset_ctrl and power_ctrl in ms. Valid options: 0-255 (default: %d)\n", DEFAULT_SETTLING_TIME_MS);
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-o : Output path (default: ~/.seekthermal/seekspi.conf)\n");
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-d : Duration in seconds to stream with each configuration; 0 only writes it (default: %d)\n", DEFAULT_DURATION_SEC);
+	fprintf(stdout, "\t   : Required - No\n");
+	fprintf(stdout, "\t-h : Displays this message\n");
+	fprintf(stdout, "\t   : Required - No\n");
+}
+
+// Parses a comma separated list of unsigned integers.
+// Returns the number of values parsed or -1 if the list is malformed or too long.
+int parse_list(const char* str, uint32_t* values, int max_values)
+{
+	int num_values = 0;
+	const char* cursor = str;
+	while(*cursor != '\0')
+	{
+		char* end = NULL;
+		errno = 0;
+		const unsigned long value = strtoul(cursor, &end, 0);
+		if(end == cursor || errno != 0 || value > UINT32_MAX || num_values >= max_values || (*end != ',' && *end != '\0'))
+		{
+			return -1;
+		}
+
+		values[num_values++] = (uint32_t)value;
+		cursor = *end == ',' ? end + 1 : end;
+	}
+
+	return num_values;
+}
+
+// Gets the user and system CPU time used by all threads of the process in seconds.
+double get_cpu_time()
+{
+	struct rusage usage;
+	memset(&usage, 0, sizeof(usage));
+	getrusage(RUSAGE_SELF, &usage);
+
+	return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+		(double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+// Gets a monotonic time in seconds.
+double get_time()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec / 1000000000.0;
+}
+
+// Callback function for a particular Seek camera.
+// This function fires whenever a frame is available; frames are only counted.
+void frame_available_callback(seekcamera_t* camera, seekcamera_frame_t* camera_frame, void* user_data)
+{
+	(void)camera;
+	(void)camera_frame;
+
+	samplectx_t* ctx = (samplectx_t*)user_data;
+	++ctx->num_frames;
+}
+
+// Handles camera connect events.
+void handle_camera_connect(seekcamera_t* camera)
+{
+	samplectx_t* ctx = NULL;
+	for(int i = 0; i < NUM_MAX_DEVICES && (ctx == NULL); ++i)
+	{
+		if(g_ctx_pool[i].is_free)
+		{
+			ctx = &(g_ctx_pool[i]);
+		}
+	}
+
+	if(ctx == NULL)
+	{
+		fprintf(stderr, "camera context pool is exhausted\n");
+		return;
+	}
+
+	ctx->is_free = false;
+	ctx->camera = camera;
+	ctx->num_frames = 0;
+	seekcamera_get_chipid(camera, &(ctx->cid));
+
+	seekcamera_error_t status = seekcamera_register_frame_available_callback(camera, frame_available_callback, (void*)ctx);
+	if(status == SEEKCAMERA_SUCCESS)
+	{
+		status = seekcamera_capture_session_start(camera, SEEKCAMERA_FRAME_FORMAT_THERMOGRAPHY_FLOAT);
+	}
+
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stderr, "failed to start capture session: %s (%s)\n", ctx->cid, seekcamera_error_get_str(status));
+	}
+}
+
+// Finds the context associated with a camera.
+// Returns NULL if the camera is not associated with any context.
+samplectx_t* find_ctx(const seekcamera_t* camera)
+{
+	for(int i = 0; i < NUM_MAX_DEVICES; ++i)
+	{
+		if(!g_ctx_pool[i].is_free && g_ctx_pool[i].camera == camera)
+		{
+			return &(g_ctx_pool[i]);
+		}
+	}
+
+	return NULL;
+}
+
+// Gets the chip ID of a camera.
+// Cameras that are already tracked are served from their cached chip ID; only newly connected cameras are queried.
+void get_cached_chipid(seekcamera_t* camera, seekcamera_chipid_t* cid)
+{
+	const samplectx_t* ctx = find_ctx(camera);
+	if(ctx != NULL)
+	{
+		memcpy(*cid, ctx->cid, sizeof(seekcamera_chipid_t));
+	}
+	else
+	{
+		seekcamera_get_chipid(camera, cid);
+	}
+}
+
+// Callback function for the Seek camera manager.
+// This function fires whenever a camera event occurs for a given camera manager context.
+void camera_event_callback(seekcamera_t* camera, seekcamera_manager_event_t event, seekcamera_error_t event_status, void* user_data)
+{
+	(void)user_data;
+
+	seekcamera_chipid_t cid;
+	get_cached_chipid(camera, &cid);
+	fprintf(stdout, "%s: %s\n", seekcamera_manager_get_event_str(event), cid);
+
+	switch(event)
+	{
+		case SEEKCAMERA_MANAGER_EVENT_CONNECT:
+			handle_camera_connect(camera);
+			break;
+		case SEEKCAMERA_MANAGER_EVENT_ERROR:
+			++g_num_errors;
+			fprintf(stderr, "encountered unexpected error: %s (%s)\n", cid, seekcamera_error_get_str(event_status));
+			break;
+		default:
+			break;
+	}
+}
+
+// Writes a configuration and streams from every SPI camera it declares for a number of seconds.
+// The SDK only reads the configuration when the camera manager is created, so a new manager is created for each trial.
+// With keep_backup, the previous configuration is kept with a .bak suffix.
+// Returns 0 on success or a negative errno value on failure.
+int run_trial(const seekspiconf_t* config, const char* path, bool keep_backup, int duration_sec, sampletrial_t* trial)
+{
+	memset(trial, 0, sizeof(sampletrial_t));
+
+	const int result = seekspiconf_write(config, path, keep_backup);
+	if(result != 0)
+	{
+		fprintf(stderr, "failed to write %s: %s\n", path, strerror(-result));
+		return result;
+	}
+
+	if(duration_sec <= 0)
+	{
+		return 0;
+	}
+
+	for(int i = 0; i < NUM_MAX_DEVICES; ++i)
+	{
+		g_ctx_pool[i].is_free = true;
+		g_ctx_pool[i].camera = NULL;
+		g_ctx_pool[i].num_frames = 0;
+	}
+	g_num_errors = 0;
+
+	seekcamera_manager_t* manager = NULL;
+	seekcamera_error_t status = seekcamera_manager_create(&manager, SEEKCAMERA_IO_TYPE_SPI);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stderr, "failed to create camera manager: %s\n", seekcamera_error_get_str(status));
+		return -EIO;
+	}
+
+	status = seekcamera_manager_register_event_callback(manager, camera_event_callback, NULL);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		fprintf(stderr, "failed to register camera event callback: %s\n", seekcamera_error_get_str(status));
+		seekcamera_manager_destroy(&manager);
+		return -EIO;
+	}
+
+	const double start_time = get_time();
+	const double start_cpu_sec = get_cpu_time();
+	while(g_keep_running && get_time() - start_time < (double)duration_sec)
+	{
+		usleep(100000);
+	}
+	trial->elapsed_sec = get_time() - start_time;
+	trial->cpu_sec = get_cpu_time() - start_cpu_sec;
+
+	// Destroying the manager stops every capture session, so the counters are stable afterwards.
+	seekcamera_manager_destroy(&manager);
+
+	for(int i = 0; i < NUM_MAX_DEVICES; ++i)
+	{
+		if(!g_ctx_pool[i].is_free)
+		{
+			++trial->num_cameras;
+			trial->num_frames += g_ctx_pool[i].num_frames;
+		}
+	}
+	trial->num_errors = g_num_errors;
+	trial->is_complete = g_keep_running;
+
+	return 0;
+}
+
+// Prints the frame rate of each camera in the last trial.
+void print_trial(const sampletrial_t* trial)
+{
+	for(int i = 0; i < NUM_MAX_DEVICES; ++i)
+	{
+		const samplectx_t* ctx = &(g_ctx_pool[i]);
+		if(!ctx->is_free)
+		{
+			fprintf(stdout, "\t%s: %llu frames (%.2f fps)\n",
+				ctx->cid,
+				(unsigned long long)ctx->num_frames,
+				trial->elapsed_sec > 0.0 ? (double)ctx->num_frames / trial->elapsed_sec : 0.0);
+		}
+	}
+
+	fprintf(stdout, "\tcameras: %zu, errors: %llu, cpu: %.1f%% of one core\n",
+		trial->num_cameras,
+		(unsigned long long)trial->num_errors,
+		trial->elapsed_sec > 0.0 ? 100.0 * trial->cpu_sec / trial->elapsed_sec : 0.0);
+}
+
+// Gets the average frame rate per camera of a trial.
+double get_trial_fps(const sampletrial_t* trial)
+{
+	if(trial->num_cameras == 0 || trial->elapsed_sec <= 0.0)
+	{
+		return 0.0;
+	}
+
+	return (double)trial->num_frames / trial->elapsed_sec / (double)trial->num_cameras;
+}
+
+// Gets the CPU time spent per frame of a trial in milliseconds.
+double get_trial_cpu_per_frame_ms(const sampletrial_t* trial)
+{
+	return trial->num_frames > 0 ? 1000.0 * trial->cpu_sec / (double)trial->num_frames : 0.0;
+}
+
+// Checks whether a trial streamed from every configured camera without errors.
+bool is_trial_clean(const sampletrial_t* trial, const seekspiconf_t* config)
+{
+	return trial->is_complete && trial->num_errors == 0 && trial->num_frames > 0 && trial->num_cameras == config->num_cameras;
+}
+
+// Checks whether a clean trial beats the best one so far.
+// The highest frame rate wins; frame rates within SWEEP_FPS_TOLERANCE of each other are ranked by CPU time per frame.
+bool is_trial_better(const sampletrial_t* trial, const sampletrial_t* best)
+{
+	const double fps = get_trial_fps(trial);
+	const double best_fps = get_trial_fps(best);
+	if(fps > best_fps * (1.0 + SWEEP_FPS_TOLERANCE))
+	{
+		return true;
+	}
+	if(fps < best_fps * (1.0 - SWEEP_FPS_TOLERANCE))
+	{
+		return false;
+	}
+
+	return get_trial_cpu_per_frame_ms(trial) < get_trial_cpu_per_frame_ms(best);
+}
+
+// Streams with every combination of speed and max transfer size and writes the best clean configuration.
+// Speeds are tried in the order given, so listing the slowest first keeps the camera usable if a faster one fails.
+// The original configuration is kept as the backup, or restored if no combination streams cleanly.
+// Returns 0 if a configuration was written, -ENODEV if none streamed cleanly or a negative errno value on failure.
+int run_sweep(
+	const seekspiconf_t* base_config,
+	const uint32_t* speeds,
+	int num_speeds,
+	const uint32_t* transfer_sizes,
+	int num_transfer_sizes,
+	const char* path,
+	int duration_sec)
+{
+	// Keep the original configuration aside; each trial overwrites it.
+	char original_path[PATH_MAX];
+	snprintf(original_path, sizeof(original_path), "%s.orig", path);
+	const bool has_original = rename(path, original_path) == 0;
+
+	seekspiconf_t best_config = *base_config;
+	sampletrial_t best_trial;
+	memset(&best_trial, 0, sizeof(best_trial));
+	bool has_best = false;
+
+	fprintf(stdout, "%12s %12s %8s %8s %10s %14s\n", "SPEED (Hz)", "XFER (B)", "CAMERAS", "ERRORS", "FPS", "CPU/FRAME (ms)");
+	fflush(stdout);
+	for(int i = 0; i < num_speeds && g_keep_running; ++i)
+	{
+		for(int j = 0; j < num_transfer_sizes && g_keep_running; ++j)
+		{
+			seekspiconf_t config = *base_config;
+			config.speed_hz = speeds[i];
+			config.max_transfer_size = transfer_sizes[j];
+
+			sampletrial_t trial;
+			// Trials must not replace the backup; only the accepted configuration does.
+			if(run_trial(&config, path, false, duration_sec, &trial) != 0)
+			{
+				continue;
+			}
+
+			const bool is_clean = is_trial_clean(&trial, &config);
+			fprintf(stdout, "%12u %12u %8zu %8llu %10.2f %14.3f%s\n",
+				config.speed_hz,
+				config.max_transfer_size,
+				trial.num_cameras,
+				(unsigned long long)trial.num_errors,
+				get_trial_fps(&trial),
+				get_trial_cpu_per_frame_ms(&trial),
+				is_clean ? "" : " (rejected)");
+			fflush(stdout);
+
+			if(is_clean && (!has_best || is_trial_better(&trial, &best_trial)))
+			{
+				best_config = config;
+				best_trial = trial;
+				has_best = true;
+			}
+		}
+	}
+
+	// Put the original configuration back so that it becomes the backup of the best one.
+	if(has_original)
+	{
+		rename(original_path, path);
+	}
+	else
+	{
+		unlink(path);
+	}
+
+	if(!has_best)
+	{
+		return -ENODEV;
+	}
+
+	fprintf(stdout, "best: %u Hz, %u bytes (%.2f fps, %.3f ms CPU per frame)\n",
+		best_config.speed_hz,
+		best_config.max_transfer_size,
+		get_trial_fps(&best_trial),
+		get_trial_cpu_per_frame_ms(&best_trial));
+
+	return seekspiconf_write(&best_config, path, true);
+}
+
+// Application entry point.
+int main(int argc, char** argv)
+{
+	// Install signal handlers.
+	signal(SIGINT, signal_callback);
+	signal(SIGTERM, signal_callback);
+
+	// Default values for the command line arguments.
+	seekspiconf_t config;
+	seekspiconf_init(&config);
+
+	uint32_t cs[SEEKSPICONF_MAX_CAMERAS] = { 0 };
+	uint32_t reset_gpios[SEEKSPICONF_MAX_CAMERAS] = { 0 };
+	uint32_t power_gpios[SEEKSPICONF_MAX_CAMERAS] = { 0 };
+	uint32_t frame_sync_gpios[SEEKSPICONF_MAX_CAMERAS] = { 0 };
+	int num_cs = 1;
+	int num_reset_gpios = 0;
+	int num_power_gpios = 0;
+	int num_frame_sync_gpios = 0;
+	int settling_time_ms = DEFAULT_SETTLING_TIME_MS;
+	uint32_t speeds[NUM_MAX_SWEEP_VALUES] = { SEEKSPICONF_DEFAULT_SPEED_HZ };
+	uint32_t transfer_sizes[NUM_MAX_SWEEP_VALUES] = { SEEKSPICONF_DEFAULT_MAX_TRANSFER_SIZE };
+	int num_speeds = 1;
+	int num_transfer_sizes = 1;
+	bool is_transfer_size_auto = false;
+	char path[PATH_MAX] = { 0 };
+	int duration_sec = DEFAULT_DURATION_SEC;
+
+	// Parse command line arguments.
+	for(int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		char ch = arg[0];
+		if(ch == '-' && strlen(arg) >= 2)
+		{
+			ch = arg[1];
+			const char* value = i < argc - 1 ? argv[i + 1] : NULL;
+			if(ch != 'h' && value == NULL)
+			{
+				print_usage();
+				return 1;
+			}
+
+			bool is_valid = true;
+			switch(ch)
+			{
+				case 'b':
+					config.bus_num = (uint32_t)strtoul(value, NULL, 0);
+					break;
+				case 'c':
+					num_cs = parse_list(value, cs, SEEKSPICONF_MAX_CAMERAS);
+					is_valid = num_cs > 0;
+					break;
+				case 's':
+					num_speeds = parse_list(value, speeds, NUM_MAX_SWEEP_VALUES);
+					is_valid = num_speeds > 0;
+					break;
+				case 't':
+					is_transfer_size_auto = strcmp(value, "auto") == 0;
+					if(!is_transfer_size_auto)
+					{
+						num_transfer_sizes = parse_list(value, transfer_sizes, NUM_MAX_SWEEP_VALUES);
+						is_valid = num_transfer_sizes > 0;
+					}
+					break;
+				case 'y':
+					config.camera_sync = strcmp(value, "on") == 0;
+					is_valid = config.camera_sync || strcmp(value, "off") == 0;
+					break;
+				case 'r':
+					num_reset_gpios = parse_list(value, reset_gpios, SEEKSPICONF_MAX_CAMERAS);
+					is_valid = num_reset_gpios > 0;
+					break;
+				case 'p':
+					num_power_gpios = parse_list(value, power_gpios, SEEKSPICONF_MAX_CAMERAS);
+					is_valid = num_power_gpios > 0;
+					break;
+				case 'f':
+					num_frame_sync_gpios = parse_list(value, frame_sync_gpios, SEEKSPICONF_MAX_CAMERAS);
+					is_valid = num_frame_sync_gpios > 0;
+					break;
+				case 'w':
+					settling_time_ms = atoi(value);
+					break;
+				case 'o':
+					snprintf(path, sizeof(path), "%s", value);
+					break;
+				case 'd':
+					duration_sec = atoi(value);
+					is_valid = duration_sec >= 0;
+					break;
+				case 'h':
+					print_usage();
+					return 0;
+				default:
+					break;
+			}
+
+			if(!is_valid)
+			{
+				print_usage();
+				return 1;
+			}
+		}
+	}
+
+	// Control lines are given per camera, in the same order as the chip selects.
+	if((num_reset_gpios > 0 && num_reset_gpios != num_cs) ||
+		(num_power_gpios > 0 && num_power_gpios != num_cs) ||
+		(num_frame_sync_gpios > 0 && num_frame_sync_gpios != num_cs))
+	{
+		fprintf(stderr, "control GPIOs must be given for every camera\n");
+		return 1;
+	}
+
+	config.num_cameras = (size_t)num_cs;
+	for(int i = 0; i < num_cs; ++i)
+	{
+		seekspiconf_camera_t* camera = &(config.cameras[i]);
+		camera->cs = cs[i];
+		if(num_reset_gpios > 0)
+		{
+			camera->reset_ctrl.type = SEEKSPICONF_CTRL_TYPE_GPIO;
+			camera->reset_ctrl.gpio = reset_gpios[i];
+			camera->reset_ctrl.settling_time_ms = (uint32_t)settling_time_ms;
+		}
+		if(num_power_gpios > 0)
+		{
+			camera->power_ctrl.type = SEEKSPICONF_CTRL_TYPE_GPIO;
+			camera->power_ctrl.gpio = power_gpios[i];
+			camera->power_ctrl.settling_time_ms = (uint32_t)settling_time_ms;
+		}
+		if(num_frame_sync_gpios > 0)
+		{
+			camera->frame_sync.type = SEEKSPICONF_CTRL_TYPE_GPIO;
+			camera->frame_sync.gpio = frame_sync_gpios[i];
+		}
+	}
+
+	// The largest transfer the running kernel accepts is the bufsiz of spidev.
+	uint32_t bufsiz = 0;
+	const bool has_bufsiz = seekspiconf_get_spidev_bufsiz(&bufsiz) == 0;
+	if(is_transfer_size_auto)
+	{
+		transfer_sizes[0] = has_bufsiz ? bufsiz : SEEKSPICONF_DEFAULT_MAX_TRANSFER_SIZE;
+		num_transfer_sizes = 1;
+	}
+
+	// Every combination of the sweep must be a valid configuration.
+	bool is_config_valid = settling_time_ms >= 0;
+	for(int i = 0; i < num_speeds && is_config_valid; ++i)
+	{
+		for(int j = 0; j < num_transfer_sizes && is_config_valid; ++j)
+		{
+			if(has_bufsiz && transfer_sizes[j] > bufsiz)
+			{
+				fprintf(stderr, "max transfer size %u exceeds the spidev bufsiz (%u); see seekspi.conf\n", transfer_sizes[j], bufsiz);
+				return 1;
+			}
+
+			config.speed_hz = speeds[i];
+			config.max_transfer_size = transfer_sizes[j];
+			is_config_valid = seekspiconf_validate(&config) == 0;
+		}
+	}
+
+	if(!is_config_valid)
+	{
+		fprintf(stderr, "invalid configuration\n");
+		print_usage();
+		return 1;
+	}
+
+	const bool is_sweep = num_speeds > 1 || num_transfer_sizes > 1;
+	if(is_sweep && duration_sec == 0)
+	{
+		fprintf(stderr, "a sweep needs a duration\n");
+		return 1;
+	}
+	config.speed_hz = speeds[0];
+	config.max_transfer_size = transfer_sizes[0];
+
+	if(path[0] == '\0')
+	{
+		const int result = seekspiconf_get_default_path(path, sizeof(path));
+		if(result != 0)
+		{
+			fprintf(stderr, "failed to get the configuration path: %s\n", strerror(-result));
+			return 1;
+		}
+	}
+
+	fprintf(stdout, "seekcamera-spi starting\n");
+	fprintf(stdout, "settings\n");
+	fprintf(stdout, "\t1) bus (-b): %u\n", config.bus_num);
+	fprintf(stdout, "\t2) cameras (-c): %zu\n", config.num_cameras);
+	fprintf(stdout, "\t3) speed (-s):");
+	for(int i = 0; i < num_speeds; ++i)
+	{
+		fprintf(stdout, "%s%u", i > 0 ? ", " : " ", speeds[i]);
+	}
+	fprintf(stdout, " Hz\n");
+	fprintf(stdout, "\t4) max transfer size (-t):");
+	for(int i = 0; i < num_transfer_sizes; ++i)
+	{
+		fprintf(stdout, "%s%u", i > 0 ? ", " : " ", transfer_sizes[i]);
+	}
+	fprintf(stdout, " bytes\n");
+	fprintf(stdout, "\t5) camera sync (-y): %s\n", config.camera_sync ? "on" : "off");
+	fprintf(stdout, "\t6) output (-o): %s\n", path);
+	fprintf(stdout, "\t7) duration (-d): %d s\n", duration_sec);
+	fflush(stdout);
+
+	if(is_sweep)
+	{
+		const int result = run_sweep(&config, speeds, num_speeds, transfer_sizes, num_transfer_sizes, path, duration_sec);
+		if(result == -ENODEV)
+		{
+			fprintf(stderr, "no configuration streamed without errors; %s is unchanged\n", path);
+			return 1;
+		}
+		if(result != 0)
+		{
+			fprintf(stderr, "failed to write %s: %s\n", path, strerror(-result));
+			return 1;
+		}
+
+		fprintf(stdout, "wrote %s\n", path);
+		return 0;
+	}
+
+	sampletrial_t trial;
+	if(run_trial(&config, path, true, duration_sec, &trial) != 0)
+	{
+		return 1;
+	}
+	fprintf(stdout, "wrote %s\n", path);
+
+	if(duration_sec > 0)
+	{
+		print_trial(&trial);
+	}
+
+	return 0;
+}
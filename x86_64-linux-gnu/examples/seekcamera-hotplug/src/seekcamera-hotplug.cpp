@@ -0,0 +1,492 @@
+/*Copyright (c) [2020] [Seek Thermal, Inc.]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The Software may only be used in combination with Seek cores/products.
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:	 Seek Thermal SDK Demo
+ * Purpose:	 Measures how quickly camera hotplug events are detected
+ * Author:	 Seek Thermal, Inc.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+// C includes
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+
+// C++ includes
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Linux includes
+#include <linux/netlink.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Seek SDK includes
+#include "seekcamera/seekcamera.h"
+#include "seekcamera/seekcamera_manager.h"
+
+// USB vendor ID of Seek Thermal cameras as it appears in the PRODUCT field of a uevent.
+// It matches the vendor ID used by the udev rules in driver/udev.
+#define SEEKHOTPLUG_VENDOR_ID "289d/"
+
+// Maximum size of a single kernel uevent.
+#define SEEKHOTPLUG_MAX_UEVENT_SIZE 8192
+
+// Structure holding the detection latency statistics of one event type.
+struct seekhotplug_stats_t
+{
+	uint64_t num_events{};
+	uint64_t num_unmatched{};
+	std::chrono::steady_clock::duration total{};
+	std::chrono::steady_clock::duration min = std::chrono::steady_clock::duration::max();
+	std::chrono::steady_clock::duration max{};
+};
+
+// Structure representing a hotplug latency monitor.
+// Kernel uevents are timestamped on a dedicated thread and matched to camera manager events by USB path.
+struct seekhotplug_t
+{
+	using clock_t = std::chrono::steady_clock;
+
+	int socket_fd = -1;
+	int wake_fd = -1;
+	std::thread thread;
+
+	std::mutex mutex;
+	std::map<std::string, clock_t::time_point> pending_add;
+	std::map<std::string, clock_t::time_point> pending_remove;
+	std::map<seekcamera_t*, std::string> paths;
+	std::map<seekcamera_t*, std::string> cids;
+	seekhotplug_stats_t connect_stats;
+	seekhotplug_stats_t disconnect_stats;
+};
+
+// Gets the kernel name of a USB device, e.g. "1-1.2" for port 2 of a hub on port 1 of bus 1.
+std::string seekhotplug_get_usb_path(const seekcamera_usb_io_properties_t& usb)
+{
+	std::stringstream path;
+	path << static_cast<int>(usb.bus_number);
+
+	char separator = '-';
+	for(uint8_t port_number : usb.port_numbers)
+	{
+		// Zero (0) is reserved for invalid ports; any non-zero ports are valid.
+		if(port_number == 0)
+		{
+			break;
+		}
+		path << separator << static_cast<int>(port_number);
+		separator = '.';
+	}
+
+	return path.str();
+}
+
+// Parses a kernel uevent.
+// Returns true if the uevent announces a Seek Thermal USB device; the action and USB path are filled in that case.
+bool seekhotplug_parse_uevent(const char* buffer, size_t size, std::string* action, std::string* path)
+{
+	bool is_usb_device = false;
+	bool is_seek_device = false;
+	action->clear();
+	path->clear();
+
+	// The uevent is a header followed by NUL terminated KEY=VALUE pairs.
+	for(size_t offset = strnlen(buffer, size) + 1; offset < size;)
+	{
+		const char* field = buffer + offset;
+		const size_t length = strnlen(field, size - offset);
+		offset += length + 1;
+
+		if(strncmp(field, "ACTION=", 7) == 0)
+		{
+			action->assign(field + 7);
+		}
+		else if(strncmp(field, "DEVPATH=", 8) == 0)
+		{
+			const char* name = strrchr(field, '/');
+			path->assign(name != nullptr ? name + 1 : field + 8);
+		}
+		else if(strcmp(field, "DEVTYPE=usb_device") == 0)
+		{
+			is_usb_device = true;
+		}
+		else if(strncmp(field, "PRODUCT=", 8) == 0)
+		{
+			is_seek_device = strncmp(field + 8, SEEKHOTPLUG_VENDOR_ID, strlen(SEEKHOTPLUG_VENDOR_ID)) == 0;
+		}
+	}
+
+	return is_usb_device && is_seek_device && !action->empty() && !path->empty();
+}
+
+// Receives kernel uevents and timestamps those of Seek Thermal USB devices.
+// The thread blocks until a uevent arrives or it is woken to stop, so it adds no wakeups of its own to the idle
+// CPU time that is measured.
+void seekhotplug_run(seekhotplug_t* hotplug)
+{
+	char buffer[SEEKHOTPLUG_MAX_UEVENT_SIZE];
+	for(;;)
+	{
+		struct pollfd pfds[2] = {
+			{ hotplug->socket_fd, POLLIN, 0 },
+			{ hotplug->wake_fd, POLLIN, 0 },
+		};
+		if(poll(pfds, 2, -1) < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			std::cerr << "failed to poll uevent socket: " << strerror(errno) << std::endl;
+			break;
+		}
+
+		if((pfds[1].revents & POLLIN) != 0)
+		{
+			break;
+		}
+
+		if((pfds[0].revents & POLLIN) == 0)
+		{
+			continue;
+		}
+
+		const ssize_t size = recv(hotplug->socket_fd, buffer, sizeof(buffer) - 1, 0);
+		if(size <= 0)
+		{
+			continue;
+		}
+		buffer[size] = '\0';
+
+		const auto now = seekhotplug_t::clock_t::now();
+		std::string action;
+		std::string path;
+		if(!seekhotplug_parse_uevent(buffer, (size_t)size, &action, &path))
+		{
+			continue;
+		}
+
+		std::cout << "uevent: " << action << " (USB: " << path << ")" << std::endl;
+
+		// Enter critical section.
+		std::lock_guard<std::mutex> lock(hotplug->mutex);
+		if(action == "add")
+		{
+			hotplug->pending_add[path] = now;
+		}
+		else if(action == "remove")
+		{
+			hotplug->pending_remove[path] = now;
+		}
+	}
+}
+
+// Subscribes to kernel uevents and starts the receiving thread.
+// Returns true on success.
+bool seekhotplug_start(seekhotplug_t* hotplug)
+{
+	hotplug->socket_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+	if(hotplug->socket_fd < 0)
+	{
+		std::cerr << "failed to create uevent socket: " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	// Group 1 carries the uevents broadcast by the kernel.
+	struct sockaddr_nl address;
+	memset(&address, 0, sizeof(address));
+	address.nl_family = AF_NETLINK;
+	address.nl_groups = 1;
+	if(bind(hotplug->socket_fd, (struct sockaddr*)&address, sizeof(address)) != 0)
+	{
+		std::cerr << "failed to bind uevent socket: " << strerror(errno) << std::endl;
+		close(hotplug->socket_fd);
+		hotplug->socket_fd = -1;
+		return false;
+	}
+
+	// Written to when the receiving thread must stop.
+	hotplug->wake_fd = eventfd(0, EFD_CLOEXEC);
+	if(hotplug->wake_fd < 0)
+	{
+		std::cerr << "failed to create eventfd: " << strerror(errno) << std::endl;
+		close(hotplug->socket_fd);
+		hotplug->socket_fd = -1;
+		return false;
+	}
+
+	hotplug->thread = std::thread(seekhotplug_run, hotplug);
+	return true;
+}
+
+// Stops the receiving thread and closes the uevent socket.
+void seekhotplug_stop(seekhotplug_t* hotplug)
+{
+	if(hotplug->thread.joinable())
+	{
+		const uint64_t value = 1;
+		if(write(hotplug->wake_fd, &value, sizeof(value)) != (ssize_t)sizeof(value))
+		{
+			std::cerr << "failed to wake uevent thread: " << strerror(errno) << std::endl;
+		}
+		hotplug->thread.join();
+	}
+
+	if(hotplug->wake_fd >= 0)
+	{
+		close(hotplug->wake_fd);
+		hotplug->wake_fd = -1;
+	}
+
+	if(hotplug->socket_fd >= 0)
+	{
+		close(hotplug->socket_fd);
+		hotplug->socket_fd = -1;
+	}
+}
+
+// Matches a camera manager event to the uevent that preceded it and records the detection latency.
+// Must be called with the monitor mutex held.
+void seekhotplug_match_locked(
+	std::map<std::string, seekhotplug_t::clock_t::time_point>& pending,
+	seekhotplug_stats_t& stats,
+	const std::string& path,
+	seekhotplug_t::clock_t::time_point event_time,
+	const char* event_str,
+	const char* cid)
+{
+	auto iter = pending.find(path);
+	if(iter == pending.end())
+	{
+		// Cameras that were connected at startup (or whose uevent was not received first) have nothing to match.
+		++stats.num_unmatched;
+		std::cout << event_str << ": no matching uevent (CID: " << cid << ", USB: " << path << ")" << std::endl;
+		return;
+	}
+
+	const auto latency = event_time - iter->second;
+	pending.erase(iter);
+
+	++stats.num_events;
+	stats.total += latency;
+	stats.min = std::min(stats.min, latency);
+	stats.max = std::max(stats.max, latency);
+
+	std::cout
+		<< event_str << ": detected in "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(latency).count() / 1000.0 << " ms"
+		<< " (CID: " << cid << ", USB: " << path << ")" << std::endl;
+}
+
+// Prints the detection latency statistics of one event type.
+void seekhotplug_print_stats(const char* name, const seekhotplug_stats_t& stats)
+{
+	auto to_ms = [](std::chrono::steady_clock::duration duration) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.0;
+	};
+
+	std::cout << '\t' << name << ": " << stats.num_events << " matched, " << stats.num_unmatched << " unmatched";
+	if(stats.num_events > 0)
+	{
+		std::cout
+			<< " (min: " << to_ms(stats.min)
+			<< " ms, mean: " << to_ms(stats.total) / (double)stats.num_events
+			<< " ms, max: " << to_ms(stats.max) << " ms)";
+	}
+	std::cout << std::endl;
+}
+
+// Gets the user and system CPU time used by all threads of the process in seconds.
+double seekhotplug_get_cpu_time()
+{
+	struct rusage usage;
+	memset(&usage, 0, sizeof(usage));
+	getrusage(RUSAGE_SELF, &usage);
+
+	return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+		(double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+// Prints the usage instructions.
+void print_usage()
+{
+	std::cout
+		<< "Allowed options:\n"
+		<< "\t-h : Displays this message\n"
+		<< "\t   : Required - No" << std::endl;
+}
+
+// Callback function for the camera manager; it fires whenever a camera event occurs.
+void camera_event_callback(seekcamera_t* camera, seekcamera_manager_event_t event, seekcamera_error_t event_status, void* user_data)
+{
+	const auto event_time = seekhotplug_t::clock_t::now();
+	auto* hotplug = (seekhotplug_t*)user_data;
+
+	// Enter critical section.
+	std::lock_guard<std::mutex> lock(hotplug->mutex);
+
+	// The chip ID is only queried when a camera connects; later events are served from the cache.
+	auto cid_iter = hotplug->cids.find(camera);
+	if(event == SEEKCAMERA_MANAGER_EVENT_CONNECT || cid_iter == hotplug->cids.end())
+	{
+		seekcamera_chipid_t chipid{};
+		seekcamera_get_chipid(camera, &chipid);
+		hotplug->cids[camera] = chipid;
+		cid_iter = hotplug->cids.find(camera);
+	}
+	const char* cid = cid_iter->second.c_str();
+
+	// Handle the event type.
+	switch(event)
+	{
+		case SEEKCAMERA_MANAGER_EVENT_CONNECT:
+		{
+			seekcamera_io_properties_t io{};
+			if(seekcamera_get_io_properties(camera, &io) != SEEKCAMERA_SUCCESS || io.type != SEEKCAMERA_IO_TYPE_USB)
+			{
+				std::cerr << "ignoring camera that is not connected over USB (CID: " << cid << ")" << std::endl;
+				break;
+			}
+
+			// The USB path is cached because the camera may no longer be reachable when it disconnects.
+			const std::string path = seekhotplug_get_usb_path(io.properties.usb);
+			hotplug->paths[camera] = path;
+			seekhotplug_match_locked(hotplug->pending_add, hotplug->connect_stats, path, event_time, seekcamera_manager_get_event_str(event), cid);
+			break;
+		}
+		case SEEKCAMERA_MANAGER_EVENT_DISCONNECT:
+		{
+			auto iter = hotplug->paths.find(camera);
+			if(iter == hotplug->paths.end())
+			{
+				break;
+			}
+
+			const std::string path = iter->second;
+			hotplug->paths.erase(iter);
+			seekhotplug_match_locked(hotplug->pending_remove, hotplug->disconnect_stats, path, event_time, seekcamera_manager_get_event_str(event), cid);
+			break;
+		}
+		case SEEKCAMERA_MANAGER_EVENT_ERROR:
+			std::cerr << "unhandled camera error: (CID: " << cid << ")" << seekcamera_error_get_str(event_status) << std::endl;
+			break;
+		default:
+			break;
+	}
+}
+
+// Application entry point.
+int main(int argc, char** argv)
+{
+	// Parse command line arguments.
+	for(int i = 1; i < argc; ++i)
+	{
+		if(strcmp(argv[i], "-h") == 0)
+		{
+			print_usage();
+			return 0;
+		}
+	}
+
+	std::cout << "seekcamera-hotplug starting" << std::endl;
+
+	// Block the termination signals before any thread is started so that every thread inherits the mask.
+	// The main thread then waits for them with sigwait instead of polling a flag.
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+	// Subscribe to kernel uevents before the camera manager is created so that no uevent is missed.
+	seekhotplug_t hotplug;
+	if(!seekhotplug_start(&hotplug))
+	{
+		return 1;
+	}
+
+	// Create the camera manager.
+	// This is the structure that owns all Seek camera devices.
+	seekcamera_manager_t* manager = nullptr;
+	seekcamera_error_t status = seekcamera_manager_create(&manager, SEEKCAMERA_IO_TYPE_USB);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		std::cerr << "failed to create camera manager: " << seekcamera_error_get_str(status) << std::endl;
+		seekhotplug_stop(&hotplug);
+		return 1;
+	}
+
+	// Register an event handler for the camera manager to be called whenever a camera event occurs.
+	status = seekcamera_manager_register_event_callback(manager, camera_event_callback, (void*)&hotplug);
+	if(status != SEEKCAMERA_SUCCESS)
+	{
+		std::cerr << "failed to register camera event callback: " << seekcamera_error_get_str(status) << std::endl;
+		seekcamera_manager_destroy(&manager);
+		seekhotplug_stop(&hotplug);
+		return 1;
+	}
+
+	// Wait until told to stop.
+	// The CPU time used by the process while waiting is reported on exit. Neither this thread nor the uevent thread
+	// wakes up on its own, so it is spent by the camera manager and on handling uevents.
+	const double start_cpu_sec = seekhotplug_get_cpu_time();
+	const auto start_time = seekhotplug_t::clock_t::now();
+	int signum = 0;
+	sigwait(&signals, &signum);
+	std::cout << "\nCaught Ctrl+C\n" << std::endl;
+	const auto elapsed = seekhotplug_t::clock_t::now() - start_time;
+	const double cpu_sec = seekhotplug_get_cpu_time() - start_cpu_sec;
+
+	// Teardown the camera manager.
+	seekcamera_manager_destroy(&manager);
+	seekhotplug_stop(&hotplug);
+
+	// Print the detection latency statistics.
+	const double elapsed_sec = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() / 1000.0;
+
+	std::cout << "detection latency:" << std::endl;
+	seekhotplug_print_stats("connect", hotplug.connect_stats);
+	seekhotplug_print_stats("disconnect", hotplug.disconnect_stats);
+	std::cout
+		<< "cpu usage:\n"
+		<< "\t" << cpu_sec << " s over " << elapsed_sec << " s"
+		<< " (" << (elapsed_sec > 0.0 ? 100.0 * cpu_sec / elapsed_sec : 0.0) << "%)" << std::endl;
+
+	return 0;
+}
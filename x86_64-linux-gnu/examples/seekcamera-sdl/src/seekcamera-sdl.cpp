@@ -36,8 +36,10 @@ SOFTWARE.
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -60,6 +62,7 @@ SOFTWARE.
 struct seekrenderer_t
 {
 	seekcamera_t* camera{};
+	seekcamera_chipid_t cid{};
 
 	// Rendering data
 	SDL_Window* window{};
@@ -70,11 +73,28 @@ struct seekrenderer_t
 	std::atomic<bool> is_active;
 	std::atomic<bool> is_dirty;
 	seekcamera_frame_t* frame{};
+
+	// Startup data
+	std::chrono::steady_clock::time_point connect_time;
+	std::chrono::steady_clock::time_point disconnect_time;
+	std::atomic<bool> is_waiting_first_frame;
+	bool is_reconnect{};
+};
+
+// Structure representing the settings of a camera that are kept across disconnects.
+// They are keyed by chip ID because a camera that re-enumerates may be given a new camera handle.
+struct seeksettings_t
+{
+	bool has_color_palette{};
+	seekcamera_color_palette_t color_palette{};
+	std::chrono::steady_clock::time_point disconnect_time;
 };
 
 // Define the global variables
 static std::atomic<bool> g_exit_requested;                       // Controls application shutdown.
 static std::map<seekcamera_t*, seekrenderer_t*> g_renderers;     // Tracks all renderers.
+static std::mutex g_settings_mutex;                              // Guards the cached settings.
+static std::map<std::string, seeksettings_t> g_settings;         // Caches settings by chip ID.
 
 // Switches the current color palette.
 // Settings will be refreshed between frames.
@@ -87,7 +107,15 @@ bool seekrenderer_switch_color_palette(seekrenderer_t* renderer)
 	// Not including the user palettes so we will cycle back to the beginning once GREEN is hit
 	current_palette = (seekcamera_color_palette_t)((current_palette + 1) % SEEKCAMERA_COLOR_PALETTE_USER_0);
 	std::cout << "color palette: " << seekcamera_color_palette_get_str(current_palette) << std::endl;
-	return seekcamera_set_color_palette(renderer->camera, current_palette) == SEEKCAMERA_SUCCESS;
+	if(seekcamera_set_color_palette(renderer->camera, current_palette) != SEEKCAMERA_SUCCESS)
+		return false;
+
+	// Remember the palette so that it can be restored if the camera reconnects.
+	std::lock_guard<std::mutex> lock(g_settings_mutex);
+	seeksettings_t& settings = g_settings[renderer->cid];
+	settings.has_color_palette = true;
+	settings.color_palette = current_palette;
+	return true;
 }
 
 // Closes the SDL window associated with a renderer.
@@ -122,12 +150,41 @@ void seekrenderer_close_window(seekrenderer_t* renderer)
 	renderer->camera = nullptr;
 }
 
+// Gets the chip ID of a camera.
+// Cameras that already have a renderer are served from its cached chip ID; only newly connected cameras are queried.
+void get_cached_chipid(seekcamera_t* camera, seekcamera_chipid_t* cid)
+{
+	const auto iter = g_renderers.find(camera);
+	if(iter != g_renderers.end() && iter->second != nullptr)
+	{
+		std::memcpy(*cid, iter->second->cid, sizeof(seekcamera_chipid_t));
+	}
+	else
+	{
+		seekcamera_get_chipid(camera, cid);
+	}
+}
+
 // Handles frame available events.
 void handle_camera_frame_available(seekcamera_t* camera, seekcamera_frame_t* camera_frame, void* user_data)
 {
 	(void)camera;
 	auto* renderer = (seekrenderer_t*)user_data;
 
+	// Report how long the camera took to stream after connecting (and after disconnecting, for reconnects).
+	if(renderer->is_waiting_first_frame.exchange(false))
+	{
+		const auto now = std::chrono::steady_clock::now();
+		const auto connect_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - renderer->connect_time).count();
+		std::cout << "first frame (CID: " << renderer->cid << "): " << connect_ms << " ms after connect";
+		if(renderer->is_reconnect)
+		{
+			const auto reconnect_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - renderer->disconnect_time).count();
+			std::cout << ", " << reconnect_ms << " ms after disconnect";
+		}
+		std::cout << std::endl;
+	}
+
 	// Lock the seekcamera frame for safe use outside of this callback.
 	seekcamera_frame_lock(camera_frame);
 	renderer->is_dirty.store(true);
@@ -145,6 +202,27 @@ void handle_camera_connect(seekcamera_t* camera, seekcamera_error_t event_status
 	renderer->is_active.store(true);
 	renderer->camera = camera;
 
+	// Cache the chip ID so that the render loop never needs to query the camera.
+	seekcamera_get_chipid(camera, &(renderer->cid));
+	renderer->connect_time = std::chrono::steady_clock::now();
+	renderer->is_reconnect = false;
+
+	// Restore the settings of a camera that was seen before so that it resumes streaming as it was.
+	{
+		std::lock_guard<std::mutex> lock(g_settings_mutex);
+		auto iter = g_settings.find(renderer->cid);
+		if(iter != g_settings.end())
+		{
+			renderer->is_reconnect = true;
+			renderer->disconnect_time = iter->second.disconnect_time;
+			if(iter->second.has_color_palette && seekcamera_set_color_palette(camera, iter->second.color_palette) != SEEKCAMERA_SUCCESS)
+			{
+				std::cerr << "failed to restore color palette (CID: " << renderer->cid << ")" << std::endl;
+			}
+		}
+	}
+	renderer->is_waiting_first_frame.store(true);
+
 	// Register a frame available callback function.
 	seekcamera_error_t status = seekcamera_register_frame_available_callback(camera, handle_camera_frame_available, (void*)renderer);
 	if(status != SEEKCAMERA_SUCCESS)
@@ -171,6 +249,15 @@ void handle_camera_disconnect(seekcamera_t* camera, seekcamera_error_t event_sta
 	(void)event_status;
 	(void)user_data;
 	auto renderer = g_renderers[camera];
+	if(renderer == nullptr)
+		return;
+
+	// Record when the camera went away so that the reconnect time can be reported.
+	{
+		std::lock_guard<std::mutex> lock(g_settings_mutex);
+		g_settings[renderer->cid].disconnect_time = std::chrono::steady_clock::now();
+	}
+
 	renderer->is_active.store(false);
 }
 
@@ -179,7 +266,7 @@ void handle_camera_error(seekcamera_t* camera, seekcamera_error_t event_status,
 {
 	(void)user_data;
 	seekcamera_chipid_t cid{};
-	seekcamera_get_chipid(camera, &cid);
+	get_cached_chipid(camera, &cid);
 	std::cerr << "unhandled camera error: (CID: " << cid << ")" << seekcamera_error_get_str(event_status) << std::endl;
 }
 
@@ -202,7 +289,7 @@ void handle_camera_ready_to_pair(seekcamera_t* camera, seekcamera_error_t event_
 void camera_event_callback(seekcamera_t* camera, seekcamera_manager_event_t event, seekcamera_error_t event_status, void* user_data)
 {
 	seekcamera_chipid_t cid{};
-	seekcamera_get_chipid(camera, &cid);
+	get_cached_chipid(camera, &cid);
 	std::cout << seekcamera_manager_get_event_str(event) << " (CID: " << cid << ")" << std::endl;
 
 	// Handle the event type.
@@ -272,10 +359,8 @@ int main()
 			if(renderer->is_active.load() && renderer->window == NULL && renderer->renderer == NULL)
 			{
 				// Set the window title.
-				seekcamera_chipid_t cid{};
-				seekcamera_get_chipid(renderer->camera, &cid);
 				std::stringstream window_title;
-				window_title << "Seek Thermal - SDL Sample (CID: " << cid << ")";
+				window_title << "Seek Thermal - SDL Sample (CID: " << renderer->cid << ")";
 
 				// Setup the window handle.
 				SDL_Window* window = SDL_CreateWindow(window_title.str().c_str(), 100, 100, 0, 0, SDL_WINDOW_HIDDEN);